@@ -0,0 +1,414 @@
+// Branching.hpp
+//
+// Branching Heuristics for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// A Brancher picks the variable Satisfy_iterative / Satisfy_iterative_BFS split on next.
+// Each search owns its own instance (they keep scratch state), created from a shared
+// BranchingConfig. Every heuristic takes a unit clause first, so propagation is never
+// delayed; they only differ in what they branch on when no unit is left.
+// Satisfy_iterative hands over the unit found by the resolution pass directly and only
+// calls pick() when there is none. A Polarity then decides which value of the variable
+// the DFS explores first.
+//
+#ifndef BRANCHING_HPP
+#define BRANCHING_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include "ClauseSetPool.hpp"
+
+struct BranchingConfig {
+        enum class Kind { ClauseOrder, StaticOrder, Vsids };
+        Kind kind = Kind::ClauseOrder;
+        std::string name = "clause order";
+        std::shared_ptr<const std::vector<int>> order;   // StaticOrder: variables by priority
+        double vsids_decay = 0.95;                       // Vsids: activity decay per conflict
+};
+
+class Brancher {
+public:
+        virtual ~Brancher() = default;
+        // Called once with the root clause set of a search.
+        virtual void start(const ClauseSet &) { }
+        // Variable to branch on in A, 0 if A has no literal left.
+        virtual int pick(const ClauseSet &A) = 0;
+        // Whether pickPresent() is worth it, i.e. the resolution step should record which
+        // variables are left in the clause sets it builds.
+        virtual bool usesPresence() const { return false; }
+        // Same as pick(A) for a set without unit clauses, given present[v] != 0 exactly for
+        // the variables of A (as recorded by ResolutionStepWithConflict).
+        virtual int pickPresent(const ClauseSet &A, const std::vector<char> & /*present*/) { return pick(A); }
+        // Both branches on `var` failed; `path` holds the assignments leading there
+        // (decisions and propagations, oldest first). Learning backends may pass the
+        // variables of a learnt clause as `path` instead.
+        virtual void conflict(int /*var*/, const std::vector<int> & /*path*/) { }
+};
+
+// Branch on the first variable of a fixed priority list that still occurs in A.
+// Falls back to the clause-order rule (first 2-literal clause, then first literal).
+class StaticOrderBrancher : public Brancher {
+public:
+        explicit StaticOrderBrancher(std::shared_ptr<const std::vector<int>> order) : order_(std::move(order)) { }
+
+        int pick(const ClauseSet &A) override {
+                if (++epoch_ == 0) {
+                        std::fill(seen_.begin(), seen_.end(), 0);
+                        epoch_ = 1;
+                }
+                int binary = 0, first = 0;
+                for (const Clause3 &cl : A) {
+                        int zeros = 0, nonzero = 0;
+                        for (int j = 0; j < 3; ++j) {
+                                int lit = cl.l[j];
+                                if (lit == 0) {
+                                        ++zeros;
+                                        continue;
+                                }
+                                nonzero = lit;
+                                std::size_t v = static_cast<std::size_t>(std::abs(lit));
+                                if (v >= seen_.size())
+                                        seen_.resize(2 * v + 1, 0);
+                                seen_[v] = epoch_;
+                        }
+                        if (zeros == 2)
+                                return std::abs(nonzero);
+                        if (zeros == 1 && binary == 0)
+                                binary = std::abs(nonzero);
+                        if (first == 0 && nonzero != 0)
+                                first = std::abs(nonzero);
+                }
+                for (int v : *order_)
+                        if (static_cast<std::size_t>(v) < seen_.size() && seen_[v] == epoch_)
+                                return v;
+                return binary ? binary : first;
+        }
+
+private:
+        std::shared_ptr<const std::vector<int>> order_;
+        std::vector<std::uint32_t> seen_;
+        std::uint32_t epoch_ = 0;
+};
+
+// EVSIDS: one activity per variable, kept in an indexed binary max-heap. A conflict bumps
+// the failed variable and the newest `window` assignments of its path by `inc`, then
+// inc /= decay, so recent conflicts weigh exponentially more (activities are rescaled
+// before they overflow). Activities start from occurrence counts in the root clause set.
+// A unit clause is still taken first; otherwise the heap is popped until a variable
+// occurring in A comes up (O(log n) per pop), and the skipped ones are pushed back.
+// In the DFS the resolution step records the variables left, so only the root of a task
+// (and a node changed by propagation) scans A in pick().
+class VsidsBrancher : public Brancher {
+public:
+        explicit VsidsBrancher(double decay = 0.95, std::size_t window = 8) : decay_(decay), window_(window) { }
+
+        void start(const ClauseSet &A) override {
+                for (const Clause3 &cl : A)
+                        for (int j = 0; j < 3; ++j)
+                                if (cl.l[j] != 0) {
+                                        int v = std::abs(cl.l[j]);
+                                        grow(v);
+                                        activity_[v] += 1e-3;
+                                        if (pos_[v] < 0)
+                                                insert(v);
+                                        else
+                                                up(pos_[v]);
+                                }
+        }
+
+        int pick(const ClauseSet &A) override {
+                if (++epoch_ == 0) {
+                        std::fill(seen_.begin(), seen_.end(), 0);
+                        epoch_ = 1;
+                }
+                int first = 0;
+                for (const Clause3 &cl : A) {
+                        int zeros = 0, nonzero = 0;
+                        for (int j = 0; j < 3; ++j) {
+                                if (cl.l[j] == 0) {
+                                        ++zeros;
+                                        continue;
+                                }
+                                nonzero = cl.l[j];
+                                int v = std::abs(nonzero);
+                                grow(v);
+                                seen_[v] = epoch_;
+                        }
+                        if (zeros == 2)
+                                return std::abs(nonzero);
+                        if (first == 0)
+                                first = std::abs(nonzero);
+                }
+                int best = top([&](int v) { return seen_[v] == epoch_; });
+                return best ? best : first;
+        }
+
+        bool usesPresence() const override { return true; }
+
+        int pickPresent(const ClauseSet &A, const std::vector<char> &present) override {
+                int best = top([&](int v) { return static_cast<std::size_t>(v) < present.size() && present[v]; });
+                return best ? best : pick(A);
+        }
+
+        void conflict(int var, const std::vector<int> &path) override {
+                bump(var);
+                std::size_t n = std::min(window_, path.size());
+                for (std::size_t k = path.size() - n; k < path.size(); ++k)
+                        bump(std::abs(path[k]));
+                inc_ /= decay_;
+                if (inc_ > 1e100) {
+                        for (double &a : activity_)
+                                a *= 1e-100;
+                        inc_ *= 1e-100;
+                }
+        }
+
+        double activity(int v) const { return static_cast<std::size_t>(v) < activity_.size() ? activity_[v] : 0.0; }
+
+private:
+        double decay_, inc_ = 1.0;
+        std::size_t window_;
+        std::vector<double> activity_;
+        std::vector<int> heap_, pos_, parked_;   // pos_[v] = index in heap_, -1 if absent
+        std::vector<std::uint32_t> seen_;
+        std::uint32_t epoch_ = 0;
+
+        // The most active variable with in(v), 0 if none; the skipped ones stay in the heap.
+        template <class In>
+        int top(In in) {
+                int best = 0;
+                parked_.clear();
+                while (!heap_.empty()) {
+                        int v = heap_[0];
+                        if (in(v)) {
+                                best = v;
+                                break;
+                        }
+                        parked_.push_back(removeTop());
+                }
+                for (int v : parked_)
+                        insert(v);
+                return best;
+        }
+        void grow(int v) {
+                if (static_cast<std::size_t>(v) >= activity_.size()) {
+                        std::size_t n = 2 * static_cast<std::size_t>(v) + 1;
+                        activity_.resize(n, 0.0);
+                        pos_.resize(n, -1);
+                        seen_.resize(n, 0);
+                }
+        }
+        void bump(int v) {
+                grow(v);
+                activity_[v] += inc_;
+                if (pos_[v] < 0)
+                        insert(v);
+                else
+                        up(pos_[v]);
+        }
+        bool before(int a, int b) const { return activity_[a] > activity_[b] || (activity_[a] == activity_[b] && a < b); }
+        void place(int v, int k) { heap_[k] = v; pos_[v] = k; }
+        void up(int k) {
+                int v = heap_[k];
+                while (k > 0 && before(v, heap_[(k - 1) / 2])) {
+                        place(heap_[(k - 1) / 2], k);
+                        k = (k - 1) / 2;
+                }
+                place(v, k);
+        }
+        void down(int k) {
+                int v = heap_[k], n = static_cast<int>(heap_.size());
+                while (2 * k + 1 < n) {
+                        int c = 2 * k + 1;
+                        if (c + 1 < n && before(heap_[c + 1], heap_[c]))
+                                ++c;
+                        if (!before(heap_[c], v))
+                                break;
+                        place(heap_[c], k);
+                        k = c;
+                }
+                place(v, k);
+        }
+        void insert(int v) {
+                heap_.push_back(v);
+                up(static_cast<int>(heap_.size()) - 1);
+        }
+        int removeTop() {
+                int v = heap_[0];
+                pos_[v] = -1;
+                int last = heap_.back();
+                heap_.pop_back();
+                if (!heap_.empty()) {
+                        place(last, 0);
+                        down(0);
+                }
+                return v;
+        }
+};
+
+// Which child of a split the DFS explores first. The original order is var = false
+// first (False). Saved repeats the value the variable had last (phase saving, false
+// until assigned), Random flips a seeded coin per split, FactorLikely looks the variable
+// up in `likely` (+1 true, -1 false, 0 false) which factorLikelyPolarity() fills from
+// the factor inputs. With `diversify`, process_queue gives worker t the policy t steps
+// further in enum order (seed + t), so the cores do not all search alike.
+struct PolarityConfig {
+        enum class Kind { False, True, Saved, Random, FactorLikely };
+        static constexpr int kinds = 5;
+        Kind kind = Kind::False;
+        std::uint64_t seed = 1;
+        std::shared_ptr<const std::vector<std::int8_t>> likely;
+        bool diversify = false;
+};
+
+inline std::string polarityName(const PolarityConfig &config) {
+        switch (config.kind) {
+        case PolarityConfig::Kind::True: return "true first";
+        case PolarityConfig::Kind::Saved: return "saved phase";
+        case PolarityConfig::Kind::Random: return "random (seed " + std::to_string(config.seed) + ")";
+        case PolarityConfig::Kind::FactorLikely: return "factor-likely";
+        default: return "false first";
+        }
+}
+
+inline PolarityConfig polarityForWorker(const PolarityConfig &config, int worker) {
+        PolarityConfig result = config;
+        if (!config.diversify)
+                return result;
+        int kind = (static_cast<int>(config.kind) + worker) % PolarityConfig::kinds;
+        result.kind = static_cast<PolarityConfig::Kind>(kind);
+        result.seed = config.seed + static_cast<std::uint64_t>(worker);
+        return result;
+}
+
+class Polarity {
+public:
+        explicit Polarity(const PolarityConfig &config) : config_(config), rng_(config.seed) { }
+
+        bool trueFirst(int var) {
+                switch (config_.kind) {
+                case PolarityConfig::Kind::True:
+                        return true;
+                case PolarityConfig::Kind::Saved:
+                        return static_cast<std::size_t>(var) < phase_.size() && phase_[var] > 0;
+                case PolarityConfig::Kind::Random:
+                        return rng_() & 1;
+                case PolarityConfig::Kind::FactorLikely:
+                        return config_.likely && static_cast<std::size_t>(var) < config_.likely->size() &&
+                               (*config_.likely)[var] > 0;
+                default:
+                        return false;
+                }
+        }
+
+        // Remember the values of freshly assigned literals (Saved only).
+        template <typename It>
+        void save(It first, It last) {
+                if (config_.kind != PolarityConfig::Kind::Saved)
+                        return;
+                for (; first != last; ++first) {
+                        std::size_t v = static_cast<std::size_t>(std::abs(*first));
+                        if (v >= phase_.size())
+                                phase_.resize(2 * v + 1, 0);
+                        phase_[v] = *first > 0 ? 1 : -1;
+                }
+        }
+
+private:
+        PolarityConfig config_;
+        std::vector<std::int8_t> phase_;
+        std::mt19937_64 rng_;
+};
+
+// Likely factor bit values: the lsbs follow from the parity of N (both 1 if N is odd,
+// otherwise FACT 1 is taken as the even one) and the msbs are 1, as for factors that
+// fill their width. Everything else keeps the false-first default.
+inline std::shared_ptr<const std::vector<std::int8_t>> factorLikelyPolarity(const std::vector<int> &v1,
+                                                                            const std::vector<int> &v2, bool odd) {
+        int max_var = 0;
+        for (int v : v1) max_var = std::max(max_var, v);
+        for (int v : v2) max_var = std::max(max_var, v);
+        auto likely = std::make_shared<std::vector<std::int8_t>>(static_cast<std::size_t>(max_var) + 1, 0);
+        if (!v1.empty()) {
+                (*likely)[v1.front()] = 1;
+                (*likely)[v1.back()] = odd ? 1 : -1;
+        }
+        if (!v2.empty()) {
+                (*likely)[v2.front()] = 1;
+                (*likely)[v2.back()] = 1;
+        }
+        return likely;
+}
+
+// Factor input bits first, interleaved p0 q0 p1 q1 ... from the lsb (or from the msb).
+// v1 / v2 are the [msb,...,lsb] lists of ExtractInputsFromDimacs.
+inline BranchingConfig inputBitsFirst(const std::vector<int> &v1, const std::vector<int> &v2, bool lsb_first) {
+        auto order = std::make_shared<std::vector<int>>();
+        std::size_t width = std::max(v1.size(), v2.size());
+        for (std::size_t k = 0; k < width; ++k) {
+                std::size_t bit = lsb_first ? k : width - 1 - k;   // 0 = lsb
+                if (bit < v1.size())
+                        order->push_back(v1[v1.size() - 1 - bit]);
+                if (bit < v2.size())
+                        order->push_back(v2[v2.size() - 1 - bit]);
+        }
+        BranchingConfig config;
+        config.kind = BranchingConfig::Kind::StaticOrder;
+        config.name = lsb_first ? "input bits lsb->msb" : "input bits msb->lsb";
+        config.order = std::move(order);
+        return config;
+}
+
+// Static order from a file: variable numbers separated by white space, highest priority
+// first; signs are ignored, lines starting with 'c' are comments. Empty on error.
+inline BranchingConfig staticOrderFromFile(const std::string &path) {
+        BranchingConfig config;
+        std::ifstream in(path);
+        if (!in.is_open())
+                return config;
+        auto order = std::make_shared<std::vector<int>>();
+        std::string line;
+        while (std::getline(in, line)) {
+                if (line.empty() || line[0] == 'c')
+                        continue;
+                std::istringstream iss(line);
+                int v;
+                while (iss >> v)
+                        if (v != 0)
+                                order->push_back(std::abs(v));
+        }
+        config.kind = BranchingConfig::Kind::StaticOrder;
+        config.name = "static order " + path;
+        config.order = std::move(order);
+        return config;
+}
+
+#endif // BRANCHING_HPP
@@ -0,0 +1,162 @@
+// Checkpoint.hpp
+//
+// Checkpoint and Resume for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// A checkpoint stores the DFS task list of a run as cubes (the BFS choices of every
+// task, no clause sets), which tasks are finished, and the options the frontier was
+// built with. --resume re-derives each unfinished task's clause set by assigning its
+// cube to the formula (assignLiterals) and continues with those tasks only.
+//
+// File layout (host byte order, all integers 32 bit unless noted):
+//   "NDPCKPT1"  magic
+//   string      input number N (decimal)
+//   string      options that shape the clause set and the frontier
+//   u32 n       number of tasks, then n times: u32 k, k literals
+//   u32 m       number of finished tasks, then m task indices
+// with string = u32 length + bytes. Files are written to <path>.tmp and renamed, so an
+// interrupted write never destroys the previous checkpoint.
+//
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+struct Checkpoint {
+        std::string input_number;
+        std::string options;
+        std::vector<std::vector<int>> cubes;   // task k = cubes[k]
+        std::vector<std::uint32_t> finished;   // tasks searched completely without a solution
+};
+
+namespace checkpoint_io {
+inline void put(std::ofstream &out, std::uint32_t v) { out.write(reinterpret_cast<const char*>(&v), sizeof(v)); }
+inline void put(std::ofstream &out, const std::string &s) {
+        put(out, static_cast<std::uint32_t>(s.size()));
+        out.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+inline bool get(std::ifstream &in, std::uint32_t &v) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&v), sizeof(v))); }
+inline bool get(std::ifstream &in, std::string &s) {
+        std::uint32_t n;
+        if (!get(in, n) || n > (1u << 20))
+                return false;
+        s.resize(n);
+        return static_cast<bool>(in.read(&s[0], n));
+}
+}
+
+inline bool writeCheckpoint(const std::string &path, const Checkpoint &cp) {
+        using namespace checkpoint_io;
+        std::string tmp = path + ".tmp";
+        {
+                std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+                if (!out.is_open())
+                        return false;
+                out.write("NDPCKPT1", 8);
+                put(out, cp.input_number);
+                put(out, cp.options);
+                put(out, static_cast<std::uint32_t>(cp.cubes.size()));
+                for (const auto &cube : cp.cubes) {
+                        put(out, static_cast<std::uint32_t>(cube.size()));
+                        out.write(reinterpret_cast<const char*>(cube.data()), static_cast<std::streamsize>(cube.size() * sizeof(int)));
+                }
+                put(out, static_cast<std::uint32_t>(cp.finished.size()));
+                out.write(reinterpret_cast<const char*>(cp.finished.data()),
+                          static_cast<std::streamsize>(cp.finished.size() * sizeof(std::uint32_t)));
+                if (!out.flush())
+                        return false;
+        }
+        return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+inline bool readCheckpoint(const std::string &path, Checkpoint &cp) {
+        using namespace checkpoint_io;
+        std::ifstream in(path, std::ios::binary);
+        char magic[8];
+        if (!in.is_open() || !in.read(magic, 8) || std::string(magic, 8) != "NDPCKPT1")
+                return false;
+        std::uint32_t n;
+        if (!get(in, cp.input_number) || !get(in, cp.options) || !get(in, n))
+                return false;
+        cp.cubes.assign(n, {});
+        for (auto &cube : cp.cubes) {
+                std::uint32_t k;
+                if (!get(in, k) || k > (1u << 24))
+                        return false;
+                cube.resize(k);
+                if (!in.read(reinterpret_cast<char*>(cube.data()), static_cast<std::streamsize>(k * sizeof(int))))
+                        return false;
+        }
+        if (!get(in, n) || n > cp.cubes.size())
+                return false;
+        cp.finished.resize(n);
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(cp.finished.data()),
+                                         static_cast<std::streamsize>(n * sizeof(std::uint32_t))));
+}
+
+// Collects finished tasks from the DFS threads and rewrites the checkpoint file at most
+// every `interval` seconds.
+class CheckpointWriter {
+public:
+        CheckpointWriter(std::string path, int interval, Checkpoint cp)
+                : path_(std::move(path)), interval_(interval), cp_(std::move(cp)), last_(std::chrono::steady_clock::now()) { }
+
+        const std::string &path() const { return path_; }
+
+        void finished(std::size_t task) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                cp_.finished.push_back(static_cast<std::uint32_t>(task));
+        }
+
+        bool write() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                last_ = std::chrono::steady_clock::now();
+                return writeCheckpoint(path_, cp_);
+        }
+
+        // Write if the interval has passed; false only if a due write failed.
+        bool tick() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto now = std::chrono::steady_clock::now();
+                if (now - last_ < std::chrono::seconds(interval_))
+                        return true;
+                last_ = now;
+                return writeCheckpoint(path_, cp_);
+        }
+
+private:
+        std::string path_;
+        int interval_;
+        std::mutex mutex_;
+        Checkpoint cp_;
+        std::chrono::steady_clock::time_point last_;
+};
+
+#endif // CHECKPOINT_HPP
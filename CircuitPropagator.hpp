@@ -0,0 +1,386 @@
+// CircuitPropagator.hpp
+//
+// Gate / XOR Recovery and Propagation for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// The Purdom-Sabry multiplier is a circuit of full and half adders. CircuitPropagator
+// recovers its gates from the Tseitin clauses of a ClauseSet:
+//
+//     XOR   a ^ b ^ c = p     the 4 clauses over {a,b,c} with matching sign parity
+//     XOR   a ^ b = p         the 2 binary clauses over {a,b}
+//     MAJ   o = maj(u,v,w)    (-u -v o)(-u -w o)(-v -w o)(u v -o)(u w -o)(v w -o)
+//     AND   o = p & q         (o -p -q)(-o p)(-o q)
+//
+// (all on literals, so OR / negated inputs are covered as well). propagate() derives
+// the consequences of one new assignment gate by gate; eliminate() runs Gauss-Jordan
+// elimination over all XOR constraints, rows bit-packed into 64-bit words and reduced
+// with word-parallel XOR, and reports units, binary equalities and parity conflicts.
+// Everything derived is implied by the clauses, so the CNF stays the reference.
+//
+#ifndef CIRCUIT_PROPAGATOR_HPP
+#define CIRCUIT_PROPAGATOR_HPP
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <unordered_set>
+#include <cstdint>
+#include <cstdlib>
+#include "ClauseSetPool.hpp"
+
+class CircuitPropagator {
+public:
+        struct Xor  { int vars[3]; int size; bool parity; };
+        struct Gate { bool maj; int out; int in[3]; };
+
+        explicit CircuitPropagator(const ClauseSet &A) { recover(A); }
+
+        std::size_t numXors() const { return xors_.size(); }
+        std::size_t numAnd() const { return gates_.size() - num_maj_; }
+        std::size_t numMaj() const { return num_maj_; }
+        bool empty() const { return xors_.empty() && gates_.empty(); }
+        int maxVar() const { return max_var_; }
+
+        // value[var]: 1 true, -1 false, 0 unassigned (size > maxVar()). Propagates the
+        // consequences of the variables in `seeds` to a fixpoint, assigning into value
+        // and appending each implied literal to `implied`. Returns false on conflict.
+        bool propagate(std::vector<std::int8_t> &value, const std::vector<int> &seeds, std::vector<int> &implied) const {
+                std::vector<int> queue(seeds);
+                for (std::size_t head = 0; head < queue.size(); ++head) {
+                        int var = queue[head];
+                        if (var <= 0 || var > max_var_)
+                                continue;
+                        for (std::uint32_t k = xor_start_[var]; k < xor_start_[var + 1]; ++k)
+                                if (!propagateXor(xors_[xor_occ_[k]], value, queue, implied))
+                                        return false;
+                        for (std::uint32_t k = gate_start_[var]; k < gate_start_[var + 1]; ++k)
+                                if (!propagateGate(gates_[gate_occ_[k]], value, queue, implied))
+                                        return false;
+                }
+                return true;
+        }
+
+        // Gauss-Jordan elimination of all XOR constraints under `value`. Rows reduced to a
+        // single variable are returned as literals in `units`, rows over two variables as
+        // equalities (a, b, parity) meaning a ^ b = parity. Returns false if a row reduces
+        // to 0 = 1.
+        bool eliminate(const std::vector<std::int8_t> &value, std::vector<int> &units,
+                       std::vector<std::array<int, 3>> &equalities) const {
+                std::vector<int> column_of(max_var_ + 1, -1), var_of;
+                for (const Xor &x : xors_)
+                        for (int j = 0; j < x.size; ++j)
+                                if (value[x.vars[j]] == 0 && column_of[x.vars[j]] < 0) {
+                                        column_of[x.vars[j]] = static_cast<int>(var_of.size());
+                                        var_of.push_back(x.vars[j]);
+                                }
+                const std::size_t cols = var_of.size();
+                const std::size_t words = (cols + 1 + 63) / 64;   // + parity column
+                const std::size_t rhs = cols;
+                std::vector<std::uint64_t> rows;
+                std::size_t num_rows = 0;
+                for (const Xor &x : xors_) {
+                        bool parity = x.parity;
+                        std::size_t base = rows.size();
+                        rows.resize(base + words, 0);
+                        bool any = false;
+                        for (int j = 0; j < x.size; ++j) {
+                                int v = x.vars[j];
+                                if (value[v] != 0) {
+                                        parity ^= (value[v] > 0);
+                                        continue;
+                                }
+                                std::size_t c = static_cast<std::size_t>(column_of[v]);
+                                rows[base + c / 64] ^= std::uint64_t(1) << (c % 64);
+                                any = true;
+                        }
+                        if (!any) {
+                                rows.resize(base);
+                                if (parity)
+                                        return false;
+                                continue;
+                        }
+                        if (parity)
+                                rows[base + rhs / 64] |= std::uint64_t(1) << (rhs % 64);
+                        ++num_rows;
+                }
+
+                std::size_t pivot_row = 0;
+                for (std::size_t c = 0; c < cols && pivot_row < num_rows; ++c) {
+                        const std::size_t w = c / 64;
+                        const std::uint64_t bit = std::uint64_t(1) << (c % 64);
+                        std::size_t r = pivot_row;
+                        while (r < num_rows && !(rows[r * words + w] & bit))
+                                ++r;
+                        if (r == num_rows)
+                                continue;
+                        if (r != pivot_row)
+                                std::swap_ranges(rows.begin() + r * words, rows.begin() + (r + 1) * words,
+                                                 rows.begin() + pivot_row * words);
+                        const std::uint64_t* pivot = rows.data() + pivot_row * words;
+                        for (std::size_t k = 0; k < num_rows; ++k) {
+                                std::uint64_t* row = rows.data() + k * words;
+                                if (k == pivot_row || !(row[w] & bit))
+                                        continue;
+                                for (std::size_t x = w; x < words; ++x)
+                                        row[x] ^= pivot[x];
+                        }
+                        ++pivot_row;
+                }
+
+                for (std::size_t k = 0; k < num_rows; ++k) {
+                        const std::uint64_t* row = rows.data() + k * words;
+                        bool parity = (row[rhs / 64] >> (rhs % 64)) & 1;
+                        int found[3] = {0, 0, 0};
+                        int count = 0;
+                        for (std::size_t x = 0; x < words && count < 3; ++x) {
+                                std::uint64_t bits = row[x];
+                                if (x == rhs / 64)
+                                        bits &= ~(std::uint64_t(1) << (rhs % 64));
+                                while (bits && count < 3) {
+                                        std::size_t c = x * 64 + static_cast<std::size_t>(__builtin_ctzll(bits));
+                                        found[count++] = var_of[c];
+                                        bits &= bits - 1;
+                                }
+                        }
+                        if (count == 0 && parity)
+                                return false;
+                        if (count == 1)
+                                units.push_back(parity ? found[0] : -found[0]);
+                        else if (count == 2)
+                                equalities.push_back({found[0], found[1], parity ? 1 : 0});
+                }
+                return true;
+        }
+
+private:
+        std::vector<Xor> xors_;
+        std::vector<Gate> gates_;
+        std::size_t num_maj_ = 0;
+        int max_var_ = 0;
+        std::vector<std::uint32_t> xor_start_, xor_occ_, gate_start_, gate_occ_;
+
+        static int litValue(const std::vector<std::int8_t> &value, int lit) {
+                int v = value[std::abs(lit)];
+                return lit > 0 ? v : -v;
+        }
+
+        // Make `lit` true. Returns false if it is already false.
+        static bool assign(int lit, std::vector<std::int8_t> &value, std::vector<int> &queue, std::vector<int> &implied) {
+                int cur = litValue(value, lit);
+                if (cur != 0)
+                        return cur > 0;
+                value[std::abs(lit)] = lit > 0 ? 1 : -1;
+                queue.push_back(std::abs(lit));
+                implied.push_back(lit);
+                return true;
+        }
+
+        static bool propagateXor(const Xor &x, std::vector<std::int8_t> &value, std::vector<int> &queue, std::vector<int> &implied) {
+                bool parity = x.parity;
+                int open = 0, free_var = 0;
+                for (int j = 0; j < x.size; ++j) {
+                        int v = value[x.vars[j]];
+                        if (v == 0) { ++open; free_var = x.vars[j]; }
+                        else parity ^= (v > 0);
+                }
+                if (open == 0)
+                        return !parity;
+                if (open == 1)
+                        return assign(parity ? free_var : -free_var, value, queue, implied);
+                return true;
+        }
+
+        static bool propagateGate(const Gate &g, std::vector<std::int8_t> &value, std::vector<int> &queue, std::vector<int> &implied) {
+                int o = litValue(value, g.out);
+                if (!g.maj) {
+                        int p = litValue(value, g.in[0]), q = litValue(value, g.in[1]);
+                        if (p < 0 || q < 0)
+                                return assign(-g.out, value, queue, implied);
+                        if (p > 0 && q > 0)
+                                return assign(g.out, value, queue, implied);
+                        if (o > 0)
+                                return assign(g.in[0], value, queue, implied) && assign(g.in[1], value, queue, implied);
+                        if (o < 0 && p > 0)
+                                return assign(-g.in[1], value, queue, implied);
+                        if (o < 0 && q > 0)
+                                return assign(-g.in[0], value, queue, implied);
+                        return true;
+                }
+                int ones = 0, zeros = 0;
+                for (int j = 0; j < 3; ++j) {
+                        int v = litValue(value, g.in[j]);
+                        ones += v > 0;
+                        zeros += v < 0;
+                }
+                if (ones >= 2)
+                        return assign(g.out, value, queue, implied);
+                if (zeros >= 2)
+                        return assign(-g.out, value, queue, implied);
+                if (o == 0 || (o > 0 ? zeros : ones) == 0)
+                        return true;
+                // Output known and one input disagrees: the two others must agree with the output.
+                for (int j = 0; j < 3; ++j)
+                        if (litValue(value, g.in[j]) == 0 && !assign(o > 0 ? g.in[j] : -g.in[j], value, queue, implied))
+                                return false;
+                return true;
+        }
+
+        struct TripleHash {
+                std::size_t operator()(const std::array<int, 3> &t) const {
+                        std::size_t h = static_cast<std::size_t>(t[0]) * 0x9E3779B97F4A7C15ULL;
+                        h ^= static_cast<std::size_t>(t[1]) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+                        h ^= static_cast<std::size_t>(t[2]) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+                        return h;
+                }
+        };
+
+        // Clauses as sorted literal triples; binaries use 0 as first element.
+        static std::array<int, 3> key(int a, int b, int c) {
+                std::array<int, 3> t{a, b, c};
+                std::sort(t.begin(), t.end());
+                return t;
+        }
+
+        void recover(const ClauseSet &A) {
+                std::unordered_set<std::array<int, 3>, TripleHash> clauses;
+                std::vector<std::array<int, 3>> full;      // 3-literal clauses
+                std::vector<std::pair<std::array<int, 3>, int>> by_vars;   // var triple, sign mask
+                for (const Clause3 &cl : A) {
+                        int lits[3], n = 0;
+                        for (int j = 0; j < 3; ++j)
+                                if (cl.l[j] != 0) {
+                                        lits[n++] = cl.l[j];
+                                        max_var_ = std::max(max_var_, std::abs(cl.l[j]));
+                                }
+                        if (n == 3) {
+                                full.push_back({lits[0], lits[1], lits[2]});
+                                clauses.insert(key(lits[0], lits[1], lits[2]));
+                        } else if (n == 2)
+                                clauses.insert(key(0, lits[0], lits[1]));
+                        if (n < 2)
+                                continue;
+                        std::array<int, 3> lit_sorted{0, 0, 0};
+                        for (int j = 0; j < n; ++j)
+                                lit_sorted[3 - n + j] = lits[j];
+                        std::sort(lit_sorted.begin(), lit_sorted.end(),
+                                  [](int a, int b) { return std::abs(a) < std::abs(b); });
+                        std::array<int, 3> vars{std::abs(lit_sorted[0]), std::abs(lit_sorted[1]), std::abs(lit_sorted[2])};
+                        if (vars[1] == vars[2] || (vars[0] != 0 && vars[0] == vars[1]))
+                                continue;
+                        int mask = (lit_sorted[0] < 0) | (lit_sorted[1] < 0) << 1 | (lit_sorted[2] < 0) << 2;
+                        by_vars.push_back({vars, mask});
+                }
+
+                // XOR: all sign patterns of one parity present over the same variables.
+                std::sort(by_vars.begin(), by_vars.end());
+                for (std::size_t k = 0; k < by_vars.size();) {
+                        std::size_t e = k;
+                        unsigned seen = 0;
+                        while (e < by_vars.size() && by_vars[e].first == by_vars[k].first)
+                                seen |= 1u << by_vars[e++].second;
+                        const auto &vars = by_vars[k].first;
+                        bool binary = vars[0] == 0;
+                        // Masks with an even number of negations forbid the odd-parity
+                        // assignments, i.e. they encode parity 1 (and vice versa).
+                        const unsigned even = binary ? 0x41u : 0x69u, odd = binary ? 0x14u : 0x96u;
+                        bool has_even = (seen & even) == even, has_odd = (seen & odd) == odd;
+                        if (has_even != has_odd) {
+                                if (binary)
+                                        xors_.push_back({{vars[1], vars[2], 0}, 2, has_even});
+                                else
+                                        xors_.push_back({{vars[0], vars[1], vars[2]}, 3, has_even});
+                        }
+                        k = e;
+                }
+
+                // Literal occurrence lists of the 3-literal clauses for gate matching.
+                std::vector<std::vector<std::uint32_t>> occ(2 * static_cast<std::size_t>(max_var_) + 2);
+                auto slot = [](int lit) { return 2 * static_cast<std::size_t>(std::abs(lit)) + (lit < 0); };
+                for (std::uint32_t k = 0; k < full.size(); ++k)
+                        for (int j = 0; j < 3; ++j)
+                                occ[slot(full[k][j])].push_back(k);
+                auto has3 = [&](int a, int b, int c) { return clauses.count(key(a, b, c)) != 0; };
+                auto has2 = [&](int a, int b) { return clauses.count(key(0, a, b)) != 0; };
+
+                // One gate per output variable; MAJ is found from each of its six clauses.
+                std::vector<char> and_out(static_cast<std::size_t>(max_var_) + 1, 0), maj_out(and_out);
+                for (const auto &c : full) {
+                        for (int j = 0; j < 3; ++j) {
+                                int o = c[j], p = -c[(j + 1) % 3], q = -c[(j + 2) % 3];
+                                // AND: (o -p -q)(-o p)(-o q)
+                                if (has2(-o, p) && has2(-o, q)) {
+                                        if (!and_out[std::abs(o)]) {
+                                                and_out[std::abs(o)] = 1;
+                                                gates_.push_back({false, o, {p, q, 0}});
+                                        }
+                                        continue;
+                                }
+                                if (maj_out[std::abs(o)])
+                                        continue;
+                                // MAJ: c = (-p -q o); find w from another (-p -w o).
+                                for (std::uint32_t k : occ[slot(o)]) {
+                                        const auto &d = full[k];
+                                        if (std::find(d.begin(), d.end(), -p) == d.end())
+                                                continue;
+                                        int w = 0;
+                                        for (int x : d)
+                                                if (x != o && x != -p)
+                                                        w = -x;
+                                        if (w == 0 || std::abs(w) == std::abs(q) || std::abs(w) == std::abs(p) || std::abs(w) == std::abs(o))
+                                                continue;
+                                        if (!has3(-q, -w, o) || !has3(p, q, -o) || !has3(p, w, -o) || !has3(q, w, -o))
+                                                continue;
+                                        maj_out[std::abs(o)] = 1;
+                                        gates_.push_back({true, o, {p, q, w}});
+                                        ++num_maj_;
+                                        break;
+                                }
+                        }
+                }
+
+                // Occurrence lists by variable (CSR).
+                auto index = [&](auto count_vars, std::vector<std::uint32_t> &start, std::vector<std::uint32_t> &list, std::size_t n) {
+                        start.assign(static_cast<std::size_t>(max_var_) + 2, 0);
+                        for (std::uint32_t k = 0; k < n; ++k)
+                                count_vars(k, [&](int v) { ++start[v + 1]; });
+                        for (std::size_t v = 1; v < start.size(); ++v)
+                                start[v] += start[v - 1];
+                        list.assign(start.back(), 0);
+                        std::vector<std::uint32_t> fill(start.begin(), start.end() - 1);
+                        for (std::uint32_t k = 0; k < n; ++k)
+                                count_vars(k, [&](int v) { list[fill[v]++] = k; });
+                };
+                index([&](std::uint32_t k, auto f) { for (int j = 0; j < xors_[k].size; ++j) f(xors_[k].vars[j]); },
+                      xor_start_, xor_occ_, xors_.size());
+                index([&](std::uint32_t k, auto f) {
+                              const Gate &g = gates_[k];
+                              f(std::abs(g.out));
+                              for (int j = 0; j < (g.maj ? 3 : 2); ++j)
+                                      f(std::abs(g.in[j]));
+                      },
+                      gate_start_, gate_occ_, gates_.size());
+        }
+};
+
+#endif // CIRCUIT_PROPAGATOR_HPP
@@ -29,16 +29,17 @@
 
 #include <vector>
 #include <cstdint>
+#include "HugePages.hpp"     // make sure to have this file in the working directory
 
 
 
-// Using default allocation for ClauseSet.
+// operator new for ClauseSet; sets of 2 MB and more on huge pages with --hugepages.
 
 struct Clause3 {
     int l[3];
 };
 
-using ClauseSet = std::vector<Clause3>;
+using ClauseSet = std::vector<Clause3, hugepages::Allocator<Clause3>>;
 
 struct ClauseSetPool {
         std::vector<ClauseSet*> freeList;
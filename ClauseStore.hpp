@@ -0,0 +1,212 @@
+// ClauseStore.hpp
+//
+// Variable-Width Clause Store for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// ClauseStore holds DIMACS clauses of any width as one flat literal array plus
+// offsets. 2-literal clauses are additionally indexed in a BinaryImplicationGraph.
+// lowerToClauseSet() hands the formula to the Clause3 engine: widths 1..3 map
+// directly (zero padded), wider clauses are split into 3-literal chains over
+// fresh variables, so pure 3-CNF input keeps the Clause3 fast path unchanged.
+//
+#ifndef CLAUSE_STORE_HPP
+#define CLAUSE_STORE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include "ClauseSetPool.hpp"
+
+struct ClauseStore {
+        std::vector<int> lits;                 // all literals, clause after clause
+        std::vector<std::uint32_t> offsets{0}; // clause k = lits[offsets[k] .. offsets[k+1])
+        int max_var = 0;
+        std::size_t width_histogram[5] = {0, 0, 0, 0, 0}; // 0, 1, 2, 3, >3 literals
+
+        std::size_t size() const { return offsets.size() - 1; }
+        std::size_t width(std::size_t k) const { return offsets[k + 1] - offsets[k]; }
+        const int* begin(std::size_t k) const { return lits.data() + offsets[k]; }
+        const int* end(std::size_t k) const { return lits.data() + offsets[k + 1]; }
+
+        void addClause(const int* first, const int* last) {
+                for (const int* p = first; p != last; ++p) {
+                        lits.push_back(*p);
+                        int v = std::abs(*p);
+                        if (v > max_var)
+                                max_var = v;
+                }
+                offsets.push_back(static_cast<std::uint32_t>(lits.size()));
+                std::size_t w = static_cast<std::size_t>(last - first);
+                ++width_histogram[w > 3 ? 4 : w];
+        }
+
+        // True if every clause fits a Clause3 without auxiliary variables.
+        bool fitsClause3() const { return width_histogram[4] == 0; }
+};
+
+// Literal index used by the implication graph: 2*(var-1) for x, 2*(var-1)+1 for -x.
+inline std::size_t litIndex(int lit) {
+        return 2 * static_cast<std::size_t>(std::abs(lit) - 1) + (lit < 0);
+}
+inline int indexLit(std::size_t idx) {
+        int v = static_cast<int>(idx / 2) + 1;
+        return (idx & 1) ? -v : v;
+}
+
+// Binary clauses (a v b) as implications -a -> b and -b -> a, in CSR layout.
+struct BinaryImplicationGraph {
+        int num_vars = 0;
+        std::vector<std::uint32_t> start; // size 2*num_vars + 1
+        std::vector<int> targets;
+
+        std::size_t numEdges() const { return targets.size(); }
+        const int* succBegin(int lit) const { return targets.data() + start[litIndex(lit)]; }
+        const int* succEnd(int lit) const { return targets.data() + start[litIndex(lit) + 1]; }
+
+        template <typename BinaryRange>
+        void build(const BinaryRange &binaries, int nv) {
+                num_vars = nv;
+                start.assign(2 * static_cast<std::size_t>(nv) + 1, 0);
+                for (const auto &b : binaries) {
+                        ++start[litIndex(-b.first) + 1];
+                        ++start[litIndex(-b.second) + 1];
+                }
+                for (std::size_t k = 1; k < start.size(); ++k)
+                        start[k] += start[k - 1];
+                targets.assign(start.back(), 0);
+                std::vector<std::uint32_t> fill(start.begin(), start.end() - 1);
+                for (const auto &b : binaries) {
+                        targets[fill[litIndex(-b.first)]++] = b.second;
+                        targets[fill[litIndex(-b.second)]++] = b.first;
+                }
+        }
+};
+
+inline BinaryImplicationGraph buildImplicationGraph(const ClauseStore &store) {
+        std::vector<std::pair<int, int>> binaries;
+        binaries.reserve(store.width_histogram[2]);
+        for (std::size_t k = 0; k < store.size(); ++k)
+                if (store.width(k) == 2)
+                        binaries.emplace_back(store.begin(k)[0], store.begin(k)[1]);
+        BinaryImplicationGraph g;
+        g.build(binaries, store.max_var);
+        return g;
+}
+
+// Tarjan SCC over the implication graph (iterative, no recursion depth limit).
+// Literals in one component are equivalent; repr[litIndex(l)] receives the literal
+// with the smallest variable of l's component, which keeps repr(-l) == -repr(l).
+// Returns false if some x and -x share a component (the clauses are unsatisfiable).
+inline bool findEquivalentLiterals(const BinaryImplicationGraph &g, std::vector<int> &repr) {
+        const std::size_t n = 2 * static_cast<std::size_t>(g.num_vars);
+        const std::uint32_t unvisited = UINT32_MAX;
+        std::vector<std::uint32_t> index(n, unvisited), low(n), next_edge(n);
+        std::vector<char> on_stack(n, 0);
+        std::vector<std::size_t> scc_stack, call_stack;
+        std::uint32_t counter = 0;
+        repr.assign(n, 0);
+        for (std::size_t root = 0; root < n; ++root) {
+                if (index[root] != unvisited)
+                        continue;
+                index[root] = low[root] = counter++;
+                next_edge[root] = g.start[root];
+                scc_stack.push_back(root);
+                on_stack[root] = 1;
+                call_stack.push_back(root);
+                while (!call_stack.empty()) {
+                        std::size_t v = call_stack.back();
+                        if (next_edge[v] < g.start[v + 1]) {
+                                std::size_t w = litIndex(g.targets[next_edge[v]++]);
+                                if (index[w] == unvisited) {
+                                        index[w] = low[w] = counter++;
+                                        next_edge[w] = g.start[w];
+                                        scc_stack.push_back(w);
+                                        on_stack[w] = 1;
+                                        call_stack.push_back(w);
+                                } else if (on_stack[w] && index[w] < low[v])
+                                        low[v] = index[w];
+                                continue;
+                        }
+                        call_stack.pop_back();
+                        if (!call_stack.empty() && low[v] < low[call_stack.back()])
+                                low[call_stack.back()] = low[v];
+                        if (low[v] != index[v])
+                                continue;
+                        std::size_t first = scc_stack.size();
+                        do { --first; } while (scc_stack[first] != v);
+                        int best = indexLit(v);
+                        for (std::size_t k = first; k < scc_stack.size(); ++k) {
+                                int lit = indexLit(scc_stack[k]);
+                                if (std::abs(lit) < std::abs(best))
+                                        best = lit;
+                        }
+                        for (std::size_t k = first; k < scc_stack.size(); ++k) {
+                                repr[scc_stack[k]] = best;
+                                on_stack[scc_stack[k]] = 0;
+                        }
+                        scc_stack.resize(first);
+                }
+        }
+        // x and -x in one component <=> both map to the same representative.
+        for (std::size_t v = 0; v + 1 < n; v += 2)
+                if (repr[v] == repr[v + 1])
+                        return false;
+        return true;
+}
+
+// Convert to the Clause3 engine format. Units become {0,0,x}, binaries {0,x,y},
+// the empty clause {0,0,0} (immediate conflict). A clause (l1 .. lk), k > 3, is
+// split into (l1 l2 y1)(-y1 l3 y2)..(-y_{k-3} l_{k-1} l_k) with fresh y's numbered
+// from num_vars + 1; num_vars is updated. The split is equisatisfiable and leaves
+// the values of the original variables untouched.
+inline ClauseSet lowerToClauseSet(const ClauseStore &store, int &num_vars) {
+        if (store.max_var > num_vars)
+                num_vars = store.max_var;
+        ClauseSet result;
+        result.reserve(store.size() + store.lits.size() / 3);
+        for (std::size_t k = 0; k < store.size(); ++k) {
+                const int* c = store.begin(k);
+                std::size_t w = store.width(k);
+                switch (w) {
+                case 0: result.push_back({{0, 0, 0}}); break;
+                case 1: result.push_back({{0, 0, c[0]}}); break;
+                case 2: result.push_back({{0, c[0], c[1]}}); break;
+                case 3: result.push_back({{c[0], c[1], c[2]}}); break;
+                default: {
+                        int y = ++num_vars;
+                        result.push_back({{c[0], c[1], y}});
+                        for (std::size_t j = 2; j + 2 < w; ++j) {
+                                int next = ++num_vars;
+                                result.push_back({{-y, c[j], next}});
+                                y = next;
+                        }
+                        result.push_back({{-y, c[w - 2], c[w - 1]}});
+                }
+                }
+        }
+        return result;
+}
+
+#endif // CLAUSE_STORE_HPP
@@ -0,0 +1,172 @@
+// CnfGenerator.hpp
+//
+// Factoring CNF Generator for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// Offline replacement for the web generator: a multiplier circuit N = FACT 1 * FACT 2
+// in the style of Paul Purdom and Amr Sabry's CNF Generator, with the header comments
+// main() and ExtractInputsFromDimacs() read:
+//
+//   c Circuit for product = N [output bits, msb first]
+//   c Variables for first input [msb,...,lsb]: [...]
+//   c Variables for second input [msb,...,lsb]: [...]
+//
+// Variable 1 is the constant false. The partial products a_i AND b_j are summed column
+// by column with full adders (two XORs and a majority gate) and half adders; the output
+// bits are fixed to N and the carries out of the top column to 0. Only 1- and 3-literal
+// clauses. randomSemiprime() picks two primes from a seed (GMP Mersenne Twister), so a
+// bit width and a seed always give the same file.
+//
+#ifndef CNF_GENERATOR_HPP
+#define CNF_GENERATOR_HPP
+
+#include <gmpxx.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class FactoringCnf {
+public:
+        // DIMACS text for N with an n1-bit first and an n2-bit second input.
+        static std::string dimacs(const mpz_class &n, int n1, int n2) {
+                FactoringCnf cnf;
+                return cnf.build(n, n1, n2);
+        }
+
+private:
+        int vars_ = 0;
+        int false_ = 0;
+        std::vector<std::vector<int>> clauses_;
+
+        int fresh() { return ++vars_; }
+
+        int andGate(int x, int y) {
+                int z = fresh();
+                clauses_.push_back({-z, x, false_});
+                clauses_.push_back({-z, y, false_});
+                clauses_.push_back({z, -x, -y});
+                return z;
+        }
+
+        int xorGate(int x, int y) {
+                int z = fresh();
+                clauses_.push_back({-x, -y, -z});
+                clauses_.push_back({x, y, -z});
+                clauses_.push_back({x, -y, z});
+                clauses_.push_back({-x, y, z});
+                return z;
+        }
+
+        int majGate(int x, int y, int c) {
+                int z = fresh();
+                clauses_.push_back({-x, -y, z});
+                clauses_.push_back({-x, -c, z});
+                clauses_.push_back({-y, -c, z});
+                clauses_.push_back({x, y, -z});
+                clauses_.push_back({x, c, -z});
+                clauses_.push_back({y, c, -z});
+                return z;
+        }
+
+        static std::string list(const std::vector<int> &lsb_first) {
+                std::ostringstream out;
+                for (std::size_t k = lsb_first.size(); k > 0; --k)
+                        out << lsb_first[k - 1] << (k > 1 ? ", " : "");
+                return out.str();
+        }
+
+        std::string build(const mpz_class &n, int n1, int n2) {
+                false_ = fresh();
+                clauses_.push_back({-false_});
+                std::vector<int> a(n1), b(n2);   // lsb first
+                for (int &v : a) v = fresh();
+                for (int &v : b) v = fresh();
+                int width = n1 + n2;
+                std::vector<std::vector<int>> columns(width + 1);
+                for (int i = 0; i < n1; ++i)
+                        for (int j = 0; j < n2; ++j)
+                                columns[i + j].push_back(andGate(a[i], b[j]));
+                std::vector<int> out;
+                for (int k = 0; k < width; ++k) {
+                        std::vector<int> &c = columns[k];
+                        while (c.size() > 1) {
+                                int x = c.back(); c.pop_back();
+                                int y = c.back(); c.pop_back();
+                                if (!c.empty()) {   // full adder
+                                        int z = c.back(); c.pop_back();
+                                        int sum = xorGate(xorGate(x, y), z);
+                                        columns[k + 1].push_back(majGate(x, y, z));
+                                        c.push_back(sum);
+                                } else {            // half adder
+                                        int sum = xorGate(x, y);
+                                        columns[k + 1].push_back(andGate(x, y));
+                                        c.push_back(sum);
+                                }
+                        }
+                        out.push_back(c.empty() ? false_ : c[0]);
+                }
+                std::ostringstream bits;
+                for (int k = 0; k < width; ++k) {
+                        bool bit = mpz_tstbit(n.get_mpz_t(), k);
+                        clauses_.push_back({bit ? out[k] : -out[k]});
+                        bits << (k ? ", " : "") << mpz_tstbit(n.get_mpz_t(), width - 1 - k);
+                }
+                for (int carry : columns[width])
+                        clauses_.push_back({-carry});
+
+                std::ostringstream dimacs;
+                dimacs << "c Circuit for product = " << n.get_str() << " [" << bits.str() << "]\n";
+                dimacs << "c Variables for first input [msb,...,lsb]: [" << list(a) << "]\n";
+                dimacs << "c Variables for second input [msb,...,lsb]: [" << list(b) << "]\n";
+                dimacs << "p cnf " << vars_ << " " << clauses_.size() << "\n";
+                for (const auto &clause : clauses_) {
+                        for (int lit : clause)
+                                dimacs << lit << " ";
+                        dimacs << "0\n";
+                }
+                return dimacs.str();
+        }
+};
+
+// Primes of (bits + 1) / 2 and bits / 2 bits with their two top bits set, so that p * q
+// has exactly `bits` bits (bits >= 4); distinct from 10 bits on, below there is too little choice.
+inline void randomSemiprime(int bits, unsigned long seed, mpz_class &p, mpz_class &q) {
+        gmp_randclass rng(gmp_randinit_mt);
+        rng.seed(seed);
+        auto prime = [&rng](int k) {
+                while (true) {
+                        mpz_class x = rng.get_z_bits(k);
+                        mpz_setbit(x.get_mpz_t(), k - 1);
+                        mpz_setbit(x.get_mpz_t(), k - 2);
+                        x -= 1;   // nextprime is the first prime > x
+                        mpz_nextprime(x.get_mpz_t(), x.get_mpz_t());
+                        if (mpz_sizeinbase(x.get_mpz_t(), 2) == static_cast<std::size_t>(k))
+                                return x;
+                }
+        };
+        p = prime((bits + 1) / 2);
+        do q = prime(bits / 2); while (q == p && bits >= 10);
+}
+
+#endif // CNF_GENERATOR_HPP
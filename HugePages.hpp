@@ -0,0 +1,218 @@
+// HugePages.hpp
+//
+// Huge Page Allocator for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// The allocator of ClauseSet (ClauseSetPool.hpp), switched on with --hugepages. Off by
+// default: every clause set comes from operator new as before. With thp or hugetlb,
+// clause sets of 2 MB and more (the original formula, the BFS frontier, the pooled DFS
+// sets of large instances) get their own 2 MB aligned mapping:
+//
+//   thp      mmap + madvise(MADV_HUGEPAGE), transparent huge pages; the kernel must
+//            allow them (/sys/kernel/mm/transparent_hugepage/enabled: always or madvise)
+//   hugetlb  mmap(MAP_HUGETLB) from the reserved pool (vm.nr_hugepages); when the pool is
+//            empty the region falls back to thp
+//
+// A region that gets neither (madvise refused) stays on 4 KB pages and is counted as a
+// fallback. Smaller sets stay with operator new: a mapping per small set would cost a
+// system call each and up to 2 MB of waste. The mode is fixed once, before the first
+// large clause set exists, because deallocate() tells the two kinds apart by size.
+//
+#ifndef HUGE_PAGES_HPP
+#define HUGE_PAGES_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace hugepages {
+
+enum class Mode { Off, Thp, Hugetlb };
+
+constexpr std::size_t kHugePage = 2 * 1024 * 1024;
+
+inline const char *modeName(Mode mode) {
+        return mode == Mode::Thp ? "thp" : mode == Mode::Hugetlb ? "hugetlb" : "off";
+}
+
+// The bracketed choice of a sysfs setting like "always [madvise] never", empty if unreadable.
+inline std::string systemSetting(const std::string &path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        std::size_t open = line.find('['), close = line.find(']');
+        if (open == std::string::npos || close == std::string::npos || close < open)
+                return line;
+        return line.substr(open + 1, close - open - 1);
+}
+
+class Regions {
+public:
+        static Regions &instance() {
+                static Regions regions;
+                return regions;
+        }
+
+        // False (with the reason) if the mode cannot be used; note explains system settings
+        // that make every region a fallback (THP off, no reserved huge pages).
+        bool configure(Mode mode, std::string &error, std::string &note) {
+#ifdef __linux__
+                if (used_.load(std::memory_order_relaxed)) {
+                        error = "clause sets of 2 MB and more were allocated before";
+                        return false;
+                }
+                std::string thp = systemSetting("/sys/kernel/mm/transparent_hugepage/enabled");
+                if (thp.empty() || thp == "never")
+                        note = "transparent huge pages are " + (thp.empty() ? std::string("not available") : "disabled (never)");
+                if (mode == Mode::Hugetlb) {
+                        std::string free_pages = systemSetting("/sys/kernel/mm/hugepages/hugepages-2048kB/free_hugepages");
+                        if (free_pages.empty() || free_pages == "0")
+                                note = "no free 2 MB pages in the vm.nr_hugepages pool, regions fall back to thp"
+                                       + (note.empty() ? std::string() : ", " + note);
+                }
+                mode_.store(mode, std::memory_order_relaxed);
+                return true;
+#else
+                (void)mode;
+                (void)note;
+                error = "huge pages are Linux only";
+                return false;
+#endif
+        }
+
+        Mode mode() const { return mode_.load(std::memory_order_relaxed); }
+
+        // Whether a block of this size has its own mapping; the same answer for allocate and free.
+        bool mapped(std::size_t bytes) {
+                if (bytes < kHugePage)
+                        return false;
+                if (!used_.load(std::memory_order_relaxed))   // written once, so the line stays shared
+                        used_.store(true, std::memory_order_relaxed);
+                return mode() != Mode::Off;
+        }
+
+        void *allocate(std::size_t bytes) {
+#ifdef __linux__
+                std::size_t size = roundUp(bytes);
+                void *p = MAP_FAILED;
+                if (mode() == Mode::Hugetlb) {
+                        p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                        if (p != MAP_FAILED)
+                                hugetlb_.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (p == MAP_FAILED) {   // thp: over-map by one huge page and trim to a 2 MB boundary
+                        void *raw = mmap(nullptr, size + kHugePage, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                        if (raw == MAP_FAILED)
+                                throw std::bad_alloc();
+                        std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(raw);
+                        std::uintptr_t aligned = (begin + kHugePage - 1) & ~static_cast<std::uintptr_t>(kHugePage - 1);
+                        std::size_t head = aligned - begin;
+                        if (head > 0)
+                                munmap(raw, head);
+                        munmap(reinterpret_cast<void *>(aligned + size), kHugePage - head);
+                        p = reinterpret_cast<void *>(aligned);
+                        if (madvise(p, size, MADV_HUGEPAGE) == 0)
+                                thp_.fetch_add(1, std::memory_order_relaxed);
+                        else
+                                fallbacks_.fetch_add(1, std::memory_order_relaxed);
+                }
+                std::uint64_t live = live_.fetch_add(size, std::memory_order_relaxed) + size;
+                std::uint64_t peak = peak_.load(std::memory_order_relaxed);
+                while (live > peak && !peak_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+                return p;
+#else
+                (void)bytes;
+                throw std::bad_alloc();
+#endif
+        }
+
+        void deallocate(void *p, std::size_t bytes) noexcept {
+#ifdef __linux__
+                std::size_t size = roundUp(bytes);
+                munmap(p, size);
+                live_.fetch_sub(size, std::memory_order_relaxed);
+#else
+                (void)p;
+                (void)bytes;
+#endif
+        }
+
+        struct Totals {
+                std::uint64_t hugetlb, thp, fallbacks;   // regions by the pages they got
+                std::uint64_t peak_bytes;
+        };
+
+        Totals totals() const {
+                return {hugetlb_.load(std::memory_order_relaxed), thp_.load(std::memory_order_relaxed),
+                        fallbacks_.load(std::memory_order_relaxed), peak_.load(std::memory_order_relaxed)};
+        }
+
+private:
+        std::atomic<Mode> mode_{Mode::Off};
+        std::atomic<bool> used_{false};
+        std::atomic<std::uint64_t> hugetlb_{0}, thp_{0}, fallbacks_{0};
+        std::atomic<std::uint64_t> live_{0}, peak_{0};
+
+        static std::size_t roundUp(std::size_t bytes) { return (bytes + kHugePage - 1) & ~(kHugePage - 1); }
+};
+
+// Stateless, so ClauseSets still move and swap freely.
+template <class T>
+struct Allocator {
+        using value_type = T;
+
+        Allocator() noexcept = default;
+        template <class U>
+        Allocator(const Allocator<U> &) noexcept { }
+
+        T *allocate(std::size_t n) {
+                std::size_t bytes = n * sizeof(T);
+                if (Regions::instance().mapped(bytes))
+                        return static_cast<T *>(Regions::instance().allocate(bytes));
+                return static_cast<T *>(::operator new(bytes));
+        }
+
+        void deallocate(T *p, std::size_t n) noexcept {
+                std::size_t bytes = n * sizeof(T);
+                if (Regions::instance().mapped(bytes))
+                        Regions::instance().deallocate(p, bytes);
+                else
+                        ::operator delete(p);
+        }
+
+        template <class U>
+        bool operator==(const Allocator<U> &) const noexcept { return true; }
+        template <class U>
+        bool operator!=(const Allocator<U> &) const noexcept { return false; }
+};
+
+} // namespace hugepages
+
+#endif // HUGE_PAGES_HPP
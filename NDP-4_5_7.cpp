@@ -55,7 +55,9 @@
 //	sudo apt update
 //	sudo apt install g++ libgmp-dev libgmpxx4ldbl libomp-dev
 //
-//	Make sure to have ClauseSetPool.hpp in the working directory.
+//	Make sure to have ClauseSetPool.hpp, ClauseStore.hpp, CircuitPropagator.hpp, Branching.hpp,
+//	Restarts.hpp, Checkpoint.hpp, Progress.hpp, Profiler.hpp, Trace.hpp, PerfCounters.hpp,
+//	PerThread.hpp, CnfGenerator.hpp, Numa.hpp and HugePages.hpp in the working directory.
 //
 // 	To compile the program on Linux (tested on Ubuntu 24.04.1 LTS), use the following command:
 // 
@@ -69,6 +71,14 @@
 // 	Once compiled, the program can be run from the command line using the following format:
 // 
 // 	./NDP-4_5_7 <dimacs_file> [-d depth | -t max_tasks | -q max_queue_size | -r reserved cores] [-o output_directory]
+//	            [--scc interval] [--gates] [--gauss interval] [--symmetry] [--lowbits k]
+//	            [--branch clause|lsb|msb|vsids|order_file] [--restart luby|geometric|lbd[:conflicts]]
+//	            [--polarity false|true|saved|random[:seed]|factor] [--diversify] [--portfolio cubes|formula]
+//	            [--cubes] [--stream depth] [--checkpoint file[:seconds]] [--resume file]
+//	            [--quiet] [--progress ms] [--progress-log file] [--task-times file] [--trace file] [--perf]
+//	            [--pin compact|scatter] [--hugepages off|thp|hugetlb]
+//
+// 	./NDP-4_5_7 --generate bits[:seed] [-o output_directory]
 // 
 // 	Command-Line Options:
 // 
@@ -78,6 +88,63 @@
 //     -q max_queues: Limit the maximum number of tasks in the BFS queue. (Optional)
 //     -r reserve_cores: Reserve a certain number of CPU cores for the system, reducing the number of cores used by the program. (Optional)
 //     -o output_directory: Specify a custom output directory for the result files. (Optional)
+//     --scc interval: Every <interval> DFS nodes, detect equivalent literals among the 2-literal clauses
+//                     (Tarjan SCC on the implication graph) and collapse them. 0 = off (default). (Optional)
+//     --gates: Recover the XOR/AND/MAJ gates of the circuit from the clauses and propagate them natively
+//              at every DFS node. (Optional)
+//     --gauss interval: Every <interval> DFS nodes, run Gaussian elimination over the recovered XORs
+//                       (implies --gates). 0 = off (default). (Optional)
+//     --symmetry: Break the p*q / q*p symmetry (FACT 1 <= FACT 2, msb->lsb comparator) and exclude the
+//                 trivial factor 1. (Optional)
+//     --lowbits k: Fix the factor bits implied by N mod 2^k (both lsbs = 1 for odd N) and seed the BFS with
+//                  one cube per admissible pair of low k-bit factor residues (k <= 12). (Optional)
+//     --branch: Branching order of BFS and DFS once no unit clause is left: clause (first clause, default),
+//               lsb / msb (factor input bits first, interleaved, from the lsb / msb), vsids (most
+//               conflict-active variable, EVSIDS), or a file with variable numbers in priority order. (Optional)
+//     --restart: Restart each DFS task from its BFS cube: luby (runs of 100 * 1,1,2,1,1,2,4,... conflicts),
+//                geometric (100, 150, 225, ... conflicts) or lbd (when the recent average LBD exceeds the
+//                global one, runs of at least 100, 150, ... conflicts). ":n" sets the 100. Pays off with
+//                --branch vsids, which keeps its activities across restarts. (Optional)
+//     --polarity: Value of the split variable the DFS explores first: false (default), true, saved (the
+//                 variable's last value), random[:seed] or factor (factor lsbs from the parity of N, msbs 1).
+//                 (Optional)
+//     --diversify: Give every DFS thread a different polarity policy (thread t: t policies further,
+//                  seed + t). (Optional)
+//     --portfolio: Run a different configuration on every DFS thread (branching, polarity, restarts and
+//                  seed rotated from the given ones): cubes (every thread works through all BFS cubes) or
+//                  formula (no BFS, every thread searches the whole formula). The first solution wins and
+//                  cancels the other threads. (Optional)
+//     --cubes: Keep the BFS frontier and the DFS tasks as cubes (choice vectors) only; every clause set is
+//              re-derived from the formula when the task is expanded or picked up. Memory per task drops
+//              from O(clauses) to O(depth), for large -q / -t. (Optional)
+//     --stream depth: Instead of the BFS, one thread expands the formula depth-first and hands every node with
+//                     `depth` two-way splits to the DFS threads at once (bounded queue), so the DFS starts
+//                     immediately. Not with --portfolio, --checkpoint or --resume. (Optional)
+//     --checkpoint: Save the DFS tasks (as BFS cubes), the finished tasks and the clause set options to a
+//                   binary file, after the BFS and then every 60 seconds (or ":seconds"). (Optional)
+//     --resume: Continue the unfinished tasks of a checkpoint instead of running the BFS. Needs the same
+//               DIMACS file, --symmetry and --lowbits; keeps checkpointing to the same file unless
+//               --checkpoint is given. (Optional)
+//     --quiet: No live progress lines on the terminal (queue size, DFS time, nodes/s, lap time). (Optional)
+//     --progress ms: Interval of the progress reporter thread in milliseconds (default 1000). (Optional)
+//     --progress-log: Append one JSON line per progress interval (phase, BFS queue/depth/tasks, DFS nodes,
+//                     finished and pending tasks) to a file, for monitoring scripts. (Optional)
+//     --task-times: Write the solve time of every DFS task (task, thread, cube literals, seconds, outcome)
+//                   to a CSV file. p50/p90/p99/max of the task times are always part of the summary. (Optional)
+//     --trace: Write a timeline of the BFS and of every DFS task per thread (task, cube size, nodes, result)
+//              in Chrome trace format, for chrome://tracing or ui.perfetto.dev. (Optional)
+//     --perf: Count cycles, instructions, L1D/LLC misses and branch misses per thread (Linux perf_event_open)
+//             for the BFS, the DFS tasks and the resolution kernel; printed after the profiling results.
+//             Runs without counters if perf is not permitted. (Optional)
+//     --generate bits[:seed]: Instead of solving, write the multiplier CNF (Purdom-Sabry style, same
+//                             header comments) of a random semiprime with `bits` bits to
+//                             rsaFACT-<bits>bit-<seed>.dimacs (default seed 1) and exit. (Optional)
+//     --pin: Pin the OpenMP workers to CPUs (Linux): compact (fill one NUMA node after the other) or scatter
+//            (workers dealt out over the nodes). The -r cores become real CPUs, taken evenly from every node.
+//            Tasks are queued per node and clause sets copied onto the node of the worker. (Optional)
+//     --hugepages: Back clause sets of 2 MB and more (formula, BFS frontier, DFS pool) with 2 MB pages:
+//                  thp (madvise(MADV_HUGEPAGE)) or hugetlb (MAP_HUGETLB, falls back to thp when no huge
+//                  pages are reserved). off (default) keeps operator new. Reported in the summary. (Optional)
 // 
 // 	Basic execution: ./NDP-4_5_7 inputs/RSA/rsaFACT-24bit.dimacs
 // 
@@ -105,7 +172,9 @@
 // 
 // 
 // 	NOTE:
-// 			only accepts input generated by Paul Purdom and Amr Sabry's CNF Generator - for code comments,
+// 			accepts DIMACS clauses of any width (1-, 2-, 3- and k-literal); the header comments
+// 			"Circuit for product = N" and "Variables for first/second input" as written by
+// 			Paul Purdom and Amr Sabry's CNF Generator are required - for code comments,
 // 			paste code into ChatGPT
 //
 //  
@@ -144,16 +213,23 @@
 #include <chrono>
 #include <unordered_map>
 #include <iomanip>
+#include <climits>
+#include <atomic>
 // Third-party library includes
 #include <omp.h>
 #include <gmpxx.h>
 #include "ClauseSetPool.hpp" // make sure to have this file in the working directory
-
-#ifdef ENABLE_PROFILING
-#define PROFILE_SCOPE(name) ScopedTimer timer##__LINE__(name)
-#else
-#define PROFILE_SCOPE(name)
-#endif
+#include "ClauseStore.hpp"   // make sure to have this file in the working directory
+#include "CircuitPropagator.hpp" // make sure to have this file in the working directory
+#include "Branching.hpp"     // make sure to have this file in the working directory
+#include "Restarts.hpp"      // make sure to have this file in the working directory
+#include "Checkpoint.hpp"    // make sure to have this file in the working directory
+#include "Progress.hpp"      // make sure to have this file in the working directory
+#include "Profiler.hpp"      // make sure to have this file in the working directory
+#include "Trace.hpp"         // make sure to have this file in the working directory
+#include "PerfCounters.hpp"  // make sure to have this file in the working directory
+#include "CnfGenerator.hpp"  // make sure to have this file in the working directory
+#include "Numa.hpp"          // make sure to have this file in the working directory
 
 #ifdef __GNUC__
   #define FORCE_INLINE inline __attribute__((always_inline))
@@ -161,52 +237,50 @@
   #define FORCE_INLINE inline
 #endif
 
-// ==========================
-// PROFILING INFRASTRUCTURE
-// ==========================
-
-std::mutex profiler_mutex;
-std::unordered_map<std::string, std::pair<double, int>> profiler_data;
-
 using big_int = mpz_class;
 
-class ScopedTimer {
-public:
-    ScopedTimer(const std::string &name)
-        : name_(name), start_(std::chrono::high_resolution_clock::now()) { }
-    ~ScopedTimer() {
-        auto end = std::chrono::high_resolution_clock::now();
-        double elapsed = std::chrono::duration<double>(end - start_).count();
-        std::lock_guard<std::mutex> lock(profiler_mutex);
-        auto &entry = profiler_data[name_];
-        entry.first += elapsed;
-        entry.second += 1;
-    }
-private:
-    std::string name_;
-    std::chrono::high_resolution_clock::time_point start_;
-};
-
-// ==========================
-// END PROFILING INFRASTRUCTURE
-// ==========================
-
 std::ostringstream output_ss;
 std::string version = "\n NDP-version: 4.5.7";
 std::atomic<bool> dfs_running{true};
+ProgressReporter progress;   // counters bumped by BFS/DFS, printed by the reporter thread
+profiling::TaskTimes task_times;   // solve time per DFS task
+Trace trace;                       // --trace timeline, DFS threads use their OpenMP number as thread ID
+constexpr int kTraceProducerThread = 1000;   // streaming BFS producer
+numa::Placement placement;         // --pin: CPU and NUMA node of every OpenMP worker
 
+// PROFILE_SCOPE (Profiler.hpp) counts per thread; dumpProfilingResults() merges the threads.
 void dumpProfilingResults() {
-    std::lock_guard<std::mutex> lock(profiler_mutex);
+    auto &registry = profiling::Registry::instance();
+    double seconds_per_tick = registry.secondsPerTick();
     std::cout << "\n\n=== Profiling Results ===\n";
-    for (const auto &entry : profiler_data) {
-        const std::string &func = entry.first;
-        double total_time = entry.second.first;
-        int calls = entry.second.second;
-        std::cout << "Function [" << func << "]: Total time = " << total_time 
-                  << " s, Calls = " << calls 
-                  << ", Avg = " << (calls ? total_time/calls : 0) << " s\n";
+    for (const auto &entry : registry.totals()) {
+        double total_time = entry.ticks * seconds_per_tick;
+        std::cout << "Function [" << entry.name << "]: Total time = " << total_time 
+                  << " s, Calls = " << entry.calls 
+                  << ", Avg = " << (entry.calls ? total_time/entry.calls : 0) << " s"
+                  << ", p50 = " << entry.latency.percentile(0.50) * seconds_per_tick
+                  << " s, p90 = " << entry.latency.percentile(0.90) * seconds_per_tick
+                  << " s, p99 = " << entry.latency.percentile(0.99) * seconds_per_tick
+                  << " s, Max = " << entry.latency.max() * seconds_per_tick << " s\n";
     }
-    std::cout << "=========================\n";
+    auto &counters = perf::Counters::instance();
+    if (counters.enabled()) {
+        std::cout << "\n=== Hardware Counters ===\n";
+        auto totals = counters.totals();
+        for (int r = 0; r < perf::kRegions; ++r) {
+            const auto &total = totals[r];
+            std::cout << "Region [" << perf::regionName(r) << "]: Calls = " << total.calls;
+            for (int c = 0; c < perf::kCounters; ++c) {
+                std::cout << ", " << perf::counterName(c) << " = ";
+                if (total.available[c]) std::cout << total.value[c];
+                else std::cout << "n/a";
+            }
+            if (total.value[perf::Cycles] > 0 && total.available[perf::Instructions])
+                std::cout << ", IPC = " << static_cast<double>(total.value[perf::Instructions]) / total.value[perf::Cycles];
+            std::cout << "\n";
+        }
+    }
+    std::cout << "=========================" << std::endl;   // std::terminate() follows, flush now
 }
 
 std::string getWorkingDirectory() {
@@ -278,52 +352,428 @@ std::string createProblemID(const std::string& input_number, int num_bits, int n
 
 // === Fixed-Size Clause Representation ===
 
-using ClauseSet = std::vector<Clause3>;
+// Clause3 and ClauseSet (with the huge page allocator of HugePages.hpp) come from ClauseSetPool.hpp.
 
-// Parse DIMACS string: convert 1-literal clauses to {0,0,x} and 3-literal clauses to {x,y,z}.
-ClauseSet parseDimacsString(const std::string &data) {
-    PROFILE_SCOPE("parseDimacsString");
+// Parse DIMACS string into a variable-width ClauseStore (flat literals + offsets).
+// Clauses may span several lines; every clause is terminated by 0.
+ClauseStore parseDimacsStore(const std::string &data) {
+    PROFILE_SCOPE("parseDimacsStore");
     std::istringstream file(data);
-    ClauseSet result;
+    ClauseStore store;
     std::string line;
+    std::vector<int> lits;
     while (std::getline(file, line)) {
-        if (line.empty() || line[0] == 'c' || line[0] == 'p')
+        if (line.empty() || line[0] == 'c' || line[0] == 'p' || line[0] == '%')
             continue;
         std::istringstream iss(line);
-        std::vector<int> lits;
         int literal;
-        while (iss >> literal && literal != 0)
-            lits.push_back(literal);
-        if (lits.size() == 1) {
-            Clause3 cl = {0, 0, lits[0]};
-            result.push_back(cl);
-        } else if (lits.size() == 3) {
-            Clause3 cl = {lits[0], lits[1], lits[2]};
-            result.push_back(cl);
+        while (iss >> literal) {
+            if (literal == 0) {
+                store.addClause(lits.data(), lits.data() + lits.size());
+                lits.clear();
+            } else
+                lits.push_back(literal);
         }
-        // Ignore clauses of unexpected size.
     }
-    return result;
+    if (!lits.empty())
+        store.addClause(lits.data(), lits.data() + lits.size());
+    return store;
+}
+
+// Parse DIMACS string into the Clause3 engine format: 1-literal clauses become {0,0,x},
+// 2-literal clauses {0,x,y}, 3-literal clauses {x,y,z}; wider clauses are split over
+// auxiliary variables numbered after num_vars (see lowerToClauseSet).
+ClauseSet parseDimacsString(const std::string &data, int &num_vars) {
+    PROFILE_SCOPE("parseDimacsString");
+    return lowerToClauseSet(parseDimacsStore(data), num_vars);
+}
+
+ClauseSet parseDimacsString(const std::string &data) {
+    int num_vars = 0;
+    return parseDimacsString(data, num_vars);
+}
+
+// True if some clause has lost all of its literals.
+inline bool hasEmptyClause(const ClauseSet &A) {
+    for (const Clause3 &cl : A)
+        if (cl.l[0] == 0 && cl.l[1] == 0 && cl.l[2] == 0)
+            return true;
+    return false;
 }
 
 struct ClauseSetBranch {
     ClauseSet cs;
     bool conflict;
+    int unit = 0;   // first 1-literal clause of cs (set by ResolutionStepWithConflict), 0 if none
+    std::vector<char> present;   // present[v] != 0 iff v occurs in cs; on request and only without a unit
 };
 
+// Substitutions var -> equivalent literal made along one search path. Batches are
+// shared between the DFS states below the node that found them (newest first).
+struct EquivalenceBatch {
+    std::vector<std::pair<int, int>> subst;
+    std::shared_ptr<const EquivalenceBatch> prev;
+};
+using EquivalenceList = std::shared_ptr<const EquivalenceBatch>;
+
 struct DFSState {
     ClauseSet* state;
     std::vector<int> choices;
     bool conflict;
+    EquivalenceList equivalences;
+    int unit;   // first unit clause of state, taken as the next split without a choice() scan
+    unsigned decisions;   // splits on the path that were not forced by a unit clause
+    std::vector<char> present;   // variables of state, empty if not known
+};
+
+// One DFS task handed from the BFS to process_queue: the BFS choices (cube) and the
+// clause set they leave (empty if tasks are stored as cubes only). Move-only, so each
+// frontier clause set is built once and consumed once by Satisfy_iterative.
+struct Task {
+    ClauseSet cs;
+    std::vector<int> cube;
+
+    Task() = default;
+    Task(ClauseSet clauses, std::vector<int> choices) : cs(std::move(clauses)), cube(std::move(choices)) { }
+    Task(Task&&) = default;
+    Task& operator=(Task&&) = default;
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+};
+using TaskQueue = std::queue<Task>;
+
+// Bounded multi-producer/multi-consumer task queue for the streaming BFS->DFS mode.
+// push() blocks while the queue is full, pop() while it is empty and not closed.
+// cancel() releases everybody: later pushes are dropped and pops fail.
+class BoundedTaskQueue {
+public:
+    explicit BoundedTaskQueue(std::size_t capacity) : capacity_(std::max<std::size_t>(capacity, 1)) { }
+
+    bool push(Task task) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [&] { return tasks_.size() < capacity_ || cancelled_; });
+        if (cancelled_)
+            return false;
+        tasks_.push(std::move(task));
+        ++pushed_;
+        not_empty_.notify_one();
+        return true;
+    }
+    bool pop(Task &task) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [&] { return !tasks_.empty() || closed_ || cancelled_; });
+        if (tasks_.empty() || cancelled_)
+            return false;
+        task = std::move(tasks_.front());
+        tasks_.pop();
+        not_full_.notify_one();
+        return true;
+    }
+    // No more tasks will come; consumers drain the rest.
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+    bool cancelled() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cancelled_;
+    }
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tasks_.size();
+    }
+    std::size_t pushed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pushed_;
+    }
+
+private:
+    std::size_t capacity_, pushed_ = 0;
+    bool closed_ = false, cancelled_ = false;
+    TaskQueue tasks_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_, not_empty_;
+};
+
+// Search settings for Satisfy_iterative.
+struct SearchConfig {
+    int scc_interval = 0;           // run equivalent-literal detection every n DFS nodes (0 = off)
+    bool gate_propagation = false;  // propagate recovered XOR/AND/MAJ gates at every DFS node
+    int gauss_interval = 0;         // Gaussian elimination over the XORs every n DFS nodes (0 = off)
+    BranchingConfig branching;      // which variable to split on (default: choice())
+    RestartConfig restarts;         // when to restart the DFS from the task root (first solution only)
+    PolarityConfig polarity;        // which value of the split variable the DFS explores first
+    const std::atomic<bool>* cancel = nullptr;  // stop the search (no result) once this is set
+    std::size_t* node_count = nullptr;          // if set, receives the number of DFS nodes searched
+};
+
+std::string describeSearchConfig(const SearchConfig &config) {
+    std::string text = config.branching.name + ", " + polarityName(config.polarity);
+    if (config.restarts.kind != RestartConfig::Kind::None)
+        text += ", " + restartName(config.restarts) + " restarts";
+    return text;
+}
+
+// Portfolio of `members` configurations: member t rotates the branching heuristic, the
+// polarity and the restart policy of `base` independently (4, 5 and 3 choices, so the
+// first 60 members all differ; member 0 is `base`) and uses seed base + t.
+std::vector<SearchConfig> makePortfolio(const SearchConfig &base, int members,
+                                        const std::vector<int> &v1, const std::vector<int> &v2) {
+    std::vector<BranchingConfig> branchings{base.branching};
+    BranchingConfig clause_order, vsids;
+    vsids.kind = BranchingConfig::Kind::Vsids;
+    vsids.name = "EVSIDS activity";
+    std::vector<BranchingConfig> candidates{clause_order, vsids};
+    if (!v1.empty() && !v2.empty()) {
+        candidates.push_back(inputBitsFirst(v1, v2, true));
+        candidates.push_back(inputBitsFirst(v1, v2, false));
+    }
+    for (const BranchingConfig &b : candidates)
+        if (branchings.size() < 4 && b.name != base.branching.name)
+            branchings.push_back(b);
+
+    std::vector<RestartConfig> restarts{base.restarts};
+    for (auto kind : {RestartConfig::Kind::None, RestartConfig::Kind::Luby, RestartConfig::Kind::Lbd}) {
+        RestartConfig r = base.restarts;
+        r.kind = kind;
+        if (restarts.size() < 3 && kind != base.restarts.kind)
+            restarts.push_back(r);
+    }
+
+    std::vector<SearchConfig> portfolio;
+    for (int t = 0; t < members; ++t) {
+        SearchConfig config = base;
+        config.branching = branchings[t % branchings.size()];
+        config.restarts = restarts[t % restarts.size()];
+        config.polarity.kind = static_cast<PolarityConfig::Kind>(
+            (static_cast<int>(base.polarity.kind) + t) % PolarityConfig::kinds);
+        config.polarity.seed = base.polarity.seed + static_cast<std::uint64_t>(t);
+        config.polarity.diversify = false;
+        portfolio.push_back(config);
+    }
+    return portfolio;
+}
+
+// Collect the clauses with exactly two literals left as an implication graph, find
+// equivalent literals with Tarjan SCC and substitute every literal by its representative.
+// Satisfied (tautological) clauses are dropped, duplicate literals zeroed, clause order kept.
+// Returns false if some x is equivalent to -x.
+bool collapseEquivalentLiterals(ClauseSet &A, EquivalenceList &equivalences) {
+    PROFILE_SCOPE("collapseEquivalentLiterals");
+    std::vector<std::pair<int, int>> binaries;
+    int max_var = 0;
+    for (const Clause3 &cl : A) {
+        int a = 0, b = 0, nonzero = 0;
+        for (int j = 0; j < 3; ++j) {
+            if (cl.l[j] == 0)
+                continue;
+            ++nonzero;
+            (a == 0 ? a : b) = cl.l[j];
+            max_var = std::max(max_var, std::abs(cl.l[j]));
+        }
+        if (nonzero == 2)
+            binaries.emplace_back(a, b);
+    }
+    if (binaries.size() < 2)
+        return true;
+
+    BinaryImplicationGraph graph;
+    graph.build(binaries, max_var);
+    std::vector<int> repr;
+    if (!findEquivalentLiterals(graph, repr))
+        return false;
+
+    auto batch = std::make_shared<EquivalenceBatch>();
+    for (int v = 1; v <= max_var; ++v)
+        if (repr[litIndex(v)] != v)
+            batch->subst.emplace_back(v, repr[litIndex(v)]);
+    if (batch->subst.empty())
+        return true;
+
+    std::size_t out = 0;
+    for (std::size_t k = 0; k < A.size(); ++k) {
+        Clause3 cl = A[k];
+        bool satisfied = false;
+        for (int j = 0; j < 3; ++j) {
+            if (cl.l[j] == 0)
+                continue;
+            cl.l[j] = repr[litIndex(cl.l[j])];
+            for (int m = 0; m < j; ++m) {
+                if (cl.l[m] == cl.l[j])
+                    cl.l[j] = 0;
+                else if (cl.l[m] == -cl.l[j] && cl.l[m] != 0)
+                    satisfied = true;
+            }
+        }
+        if (!satisfied)
+            A[out++] = cl;
+    }
+    A.resize(out);
+    batch->prev = std::move(equivalences);
+    equivalences = std::move(batch);
+    return true;
+}
+
+// Extend a satisfying cube with the values of the variables removed by
+// collapseEquivalentLiterals. Unassigned variables count as false, as in convert().
+void appendEquivalentLiterals(std::vector<int> &assignment, const EquivalenceList &equivalences) {
+    if (!equivalences)
+        return;
+    std::unordered_set<int> true_vars;
+    for (int lit : assignment)
+        if (lit > 0)
+            true_vars.insert(lit);
+    for (const EquivalenceBatch* batch = equivalences.get(); batch; batch = batch->prev.get()) {
+        for (const auto &[var, lit] : batch->subst) {
+            bool value = (true_vars.count(std::abs(lit)) != 0) == (lit > 0);
+            assignment.push_back(value ? var : -var);
+            if (value)
+                true_vars.insert(var);
+        }
+    }
+}
+
+// Assign all literals of `lits` in one pass; equals a chain of ResolutionSteps taking the
+// true branch each time. If `present` is given, present[k] tells whether lits[k] occurred in A.
+ClauseSetBranch assignLiterals(const ClauseSet &A, const std::vector<int> &lits, std::vector<char>* present = nullptr) {
+    PROFILE_SCOPE("assignLiterals");
+    int max_var = 0;
+    for (int lit : lits)
+        max_var = std::max(max_var, std::abs(lit));
+    std::vector<int> slot(max_var + 1, -1);   // var -> index in lits
+    for (std::size_t k = 0; k < lits.size(); ++k)
+        slot[std::abs(lits[k])] = static_cast<int>(k);
+    if (present)
+        present->assign(lits.size(), 0);
+
+    ClauseSetBranch branch;
+    branch.conflict = false;
+    branch.cs.reserve(A.size());
+    for (const Clause3 &cl : A) {
+        Clause3 out = cl;
+        bool satisfied = false;
+        for (int j = 0; j < 3; ++j) {
+            int lit = cl.l[j];
+            int v = std::abs(lit);
+            if (lit == 0 || v > max_var || slot[v] < 0)
+                continue;
+            int assigned = lits[slot[v]];
+            if (present)
+                (*present)[slot[v]] = 1;
+            if (assigned == lit)
+                satisfied = true;
+            else
+                out.l[j] = 0;
+        }
+        if (satisfied)
+            continue;
+        if (out.l[0] == 0 && out.l[1] == 0 && out.l[2] == 0)
+            branch.conflict = true;
+        branch.cs.push_back(out);
+    }
+    return branch;
+}
+
+// Per-task state of the recovered-circuit propagation in Satisfy_iterative.
+struct CircuitSearch {
+    CircuitPropagator circuit;
+    std::vector<std::int8_t> value;
+    std::vector<int> implied, units;
+    std::vector<std::array<int, 3>> equalities;
+    std::vector<char> present;
+
+    explicit CircuitSearch(const ClauseSet &A) : circuit(A), value(circuit.maxVar() + 1, 0) { }
+
+    // Propagate the gates from the newest choice (and run Gaussian elimination if `gauss`),
+    // then assign everything implied to A and append the literals that occurred in A to
+    // `choices`. Equalities found by elimination are added as binary clauses if
+    // `add_equalities`. Returns false on conflict.
+    bool run(ClauseSet &A, std::vector<int> &choices, bool gauss, bool add_equalities) {
+        PROFILE_SCOPE("CircuitSearch::run");
+        for (int lit : choices)
+            if (std::abs(lit) < static_cast<int>(value.size()))
+                value[std::abs(lit)] = lit > 0 ? 1 : -1;
+        implied.clear();
+        std::vector<int> seeds;
+        if (!choices.empty())
+            seeds.push_back(std::abs(choices.back()));
+        bool ok = circuit.propagate(value, seeds, implied);
+        equalities.clear();
+        if (ok && gauss) {
+            units.clear();
+            ok = circuit.eliminate(value, units, equalities);
+            seeds.clear();
+            for (std::size_t k = 0; ok && k < units.size(); ++k) {
+                int cur = value[std::abs(units[k])];
+                if (cur != 0) {
+                    ok = (cur > 0) == (units[k] > 0);
+                    continue;
+                }
+                value[std::abs(units[k])] = units[k] > 0 ? 1 : -1;
+                implied.push_back(units[k]);
+                seeds.push_back(std::abs(units[k]));
+            }
+            ok = ok && circuit.propagate(value, seeds, implied);
+        }
+        for (int lit : choices)
+            if (std::abs(lit) < static_cast<int>(value.size()))
+                value[std::abs(lit)] = 0;
+        for (int lit : implied)
+            value[std::abs(lit)] = 0;
+        if (!ok)
+            return false;
+
+        if (!implied.empty()) {
+            ClauseSetBranch reduced = assignLiterals(A, implied, &present);
+            if (reduced.conflict)
+                return false;
+            A = std::move(reduced.cs);
+            for (std::size_t k = 0; k < implied.size(); ++k)
+                if (present[k])
+                    choices.push_back(implied[k]);
+        }
+        if (add_equalities && !equalities.empty()) {
+            // Only relate variables still in A: a variable that left A (assigned, satisfied
+            // away or substituted by collapseEquivalentLiterals) must not come back.
+            std::vector<char> in_A(value.size(), 0);
+            for (const Clause3 &cl : A)
+                for (int j = 0; j < 3; ++j)
+                    if (cl.l[j] != 0 && std::abs(cl.l[j]) < static_cast<int>(in_A.size()))
+                        in_A[std::abs(cl.l[j])] = 1;
+            for (const auto &e : equalities) {
+                if (!in_A[e[0]] || !in_A[e[1]])
+                    continue;
+                int b = e[2] ? -e[1] : e[1];   // a ^ b = p  <=>  a == (p ? -b : b)
+                A.push_back({{0, e[0], -b}});
+                A.push_back({{0, -e[0], b}});
+            }
+        }
+        return true;
+    }
 };
 
-inline std::pair<ClauseSetBranch, ClauseSetBranch> ResolutionStepWithConflict(const ClauseSet &A, int i) {
+// With presence_size > 0 (one more than the largest variable of A), each branch also
+// records the variables left in it, so the brancher does not scan the set again.
+inline std::pair<ClauseSetBranch, ClauseSetBranch> ResolutionStepWithConflict(const ClauseSet &A, int i,
+                                                                              std::size_t presence_size = 0) {
     // Prepare output branch containers.
     ClauseSetBranch branchLA, branchRA;
     branchLA.conflict = false;
     branchRA.conflict = false;
     branchLA.cs.reserve(A.size());
     branchRA.cs.reserve(A.size());
+    const bool track = presence_size > 0;
+    if (track) {
+        branchLA.present.assign(presence_size, 0);
+        branchRA.present.assign(presence_size, 0);
+    }
     
     // Process each clause once.
     for (const Clause3 &cl : A) {
@@ -352,17 +802,37 @@ inline std::pair<ClauseSetBranch, ClauseSetBranch> ResolutionStepWithConflict(co
         // For LA branch: if not satisfied, check for conflict and add clause.
         if (!skipLA) {
             // If every literal is zero, then the clause is contradictory.
-            if (newLA.l[0] == 0 && newLA.l[1] == 0 && newLA.l[2] == 0)
+            int nonzero = (newLA.l[0] != 0) + (newLA.l[1] != 0) + (newLA.l[2] != 0);
+            if (nonzero == 0)
                 branchLA.conflict = true;
+            else if (nonzero == 1 && branchLA.unit == 0)
+                branchLA.unit = newLA.l[0] | newLA.l[1] | newLA.l[2];
+            if (track && branchLA.unit == 0)
+                for (int j = 0; j < 3; ++j)
+                    branchLA.present[std::abs(newLA.l[j])] = 1;
             branchLA.cs.push_back(newLA);
         }
         // Repeat for RA branch.
         if (!skipRA) {
-            if (newRA.l[0] == 0 && newRA.l[1] == 0 && newRA.l[2] == 0)
+            int nonzero = (newRA.l[0] != 0) + (newRA.l[1] != 0) + (newRA.l[2] != 0);
+            if (nonzero == 0)
                 branchRA.conflict = true;
+            else if (nonzero == 1 && branchRA.unit == 0)
+                branchRA.unit = newRA.l[0] | newRA.l[1] | newRA.l[2];
+            if (track && branchRA.unit == 0)
+                for (int j = 0; j < 3; ++j)
+                    branchRA.present[std::abs(newRA.l[j])] = 1;
             branchRA.cs.push_back(newRA);
         }
     }
+    // A branch with a unit splits on it without asking the brancher, so recording stopped
+    // at its first unit clause; index 0 collected the zeroed literals.
+    for (ClauseSetBranch *branch : {&branchLA, &branchRA}) {
+        if (branch->unit != 0)
+            branch->present = std::vector<char>();
+        else if (track)
+            branch->present[0] = 0;
+    }
     return { std::move(branchLA), std::move(branchRA) };
 }
 
@@ -441,26 +911,91 @@ inline int choice(const ClauseSet &A) {
     return 0;
 }
 
+// Default heuristic: choice() (first unit, then first 2-literal clause, then first literal).
+class ClauseOrderBrancher : public Brancher {
+public:
+    int pick(const ClauseSet &A) override { return choice(A); }
+};
+
+std::unique_ptr<Brancher> makeBrancher(const BranchingConfig &config) {
+    switch (config.kind) {
+    case BranchingConfig::Kind::StaticOrder:
+        return std::make_unique<StaticOrderBrancher>(config.order);
+    case BranchingConfig::Kind::Vsids:
+        return std::make_unique<VsidsBrancher>(config.vsids_decay);
+    case BranchingConfig::Kind::ClauseOrder:
+    default:
+        return std::make_unique<ClauseOrderBrancher>();
+    }
+}
+
 // Satisfy_iterative: DFS search on ClauseSet.
-std::vector<std::vector<int>> Satisfy_iterative(ClauseSet A, bool firstAssignment = false) {
+std::vector<std::vector<int>> Satisfy_iterative(ClauseSet A, bool firstAssignment = false,
+                                                const SearchConfig &config = SearchConfig()) {
     PROFILE_SCOPE("Satisfy_iterative_with_pool");
     ClauseSetPool csPool;  // Use pool as before.
     
     // Instead of (ClauseSet*, vector<int>) pairs, we now use DFSState.
     std::vector<DFSState> stack;
     
-    // Obtain initial state from pool. Since the input DIMACS should be conflict–free,
-    // we mark it as not conflicted.
+    // Obtain initial state from pool. The input may carry an empty clause (e.g. an
+    // empty DIMACS clause), so the root conflict flag is computed once here.
     ClauseSet* initialState = csPool.obtain(A.size());
     *initialState = std::move(A);
-    stack.push_back({initialState, {}, false});
+    const bool root_conflict = hasEmptyClause(*initialState);
+    stack.push_back({initialState, {}, root_conflict, nullptr, 0, 0, {}});
     
     std::vector<std::vector<int>> results;
     std::set<std::vector<int>> unique_results;
     bool found_first_assignment = false;
+    std::size_t nodes = 0;
+    SearchStats stats;   // added to this thread's WorkerStats every 4096 nodes
+    WorkerStats &worker_stats = progress.worker(omp_get_thread_num());
+    std::unique_ptr<Brancher> brancher = makeBrancher(config.branching);
+    brancher->start(*initialState);
+    std::size_t presence_size = 0;   // largest variable + 1 if the brancher uses presence
+    if (brancher->usesPresence()) {
+        for (const Clause3 &cl : *initialState)
+            for (int j = 0; j < 3; ++j)
+                presence_size = std::max<std::size_t>(presence_size, std::abs(cl.l[j]) + 1);
+    }
+    Polarity polarity(config.polarity);
+    std::unique_ptr<CircuitSearch> circuit;
+    if (config.gate_propagation || config.gauss_interval > 0)
+        circuit = std::make_unique<CircuitSearch>(*initialState);
+    // Restarts go back to the task root, so keep a copy of it. Only when looking for the
+    // first solution: enumerating all of them would revisit the same subtrees.
+    RestartPolicy restarts(firstAssignment ? config.restarts : RestartConfig());
+    ClauseSet root;
+    if (restarts.enabled())
+        root = *initialState;
+    // Count a conflict. On a restart, drop the DFS stack, push the root again and return true.
+    auto conflict = [&](int var, const std::vector<int> &path, unsigned decisions) {
+        ++stats.conflicts;
+        brancher->conflict(var, path);
+        if (!restarts.conflict(decisions))
+            return false;
+        for (DFSState &s : stack)
+            csPool.release(s.state);
+        stack.clear();
+        ClauseSet* restart = csPool.obtain(root.size());
+        *restart = root;
+        stack.push_back({restart, {}, root_conflict, nullptr, 0, 0, {}});
+        restarts.restarted();
+        return true;
+    };
+    auto record = [&](const std::vector<int> &assignment, const EquivalenceList &equivalences) {
+        if (!unique_results.insert(assignment).second)
+            return false;
+        results.push_back(assignment);
+        appendEquivalentLiterals(results.back(), equivalences);
+        return true;
+    };
     
     while (!stack.empty()) {
         PROFILE_SCOPE("Satisfy_iterative_loop_with_pool");
+        if (config.cancel && config.cancel->load(std::memory_order_relaxed))
+            break;
         
         // Pop a DFS state.
         DFSState current = std::move(stack.back());
@@ -473,11 +1008,54 @@ std::vector<std::vector<int>> Satisfy_iterative(ClauseSet A, bool firstAssignmen
         }
         ClauseSet* current_A = current.state;
         std::vector<int> choices = std::move(current.choices);
+        EquivalenceList equivalences = std::move(current.equivalences);
+        
+        int unit = current.unit;
+        unsigned decisions = current.decisions;
+        std::vector<char> present = std::move(current.present);
+        
+        std::size_t node = nodes++;
+        ++stats.nodes;
+        stats.max_depth = std::max<std::uint64_t>(stats.max_depth, choices.size());
+        if ((nodes & 4095) == 0) {
+            worker_stats.add(stats);
+            stats = SearchStats();
+        }
+        std::size_t new_choices_from = choices.empty() ? 0 : choices.size() - 1;
+        if (circuit) {
+            bool gauss = config.gauss_interval > 0 && node % config.gauss_interval == 0;
+            std::size_t assigned = choices.size(), clauses = current_A->size();
+            if (!circuit->run(*current_A, choices, gauss, config.scc_interval > 0)) {
+                csPool.release(current_A);
+                if (!choices.empty())
+                    conflict(std::abs(choices.back()), choices, decisions);
+                continue;
+            }
+            if (choices.size() != assigned || current_A->size() != clauses) {
+                unit = 0;
+                present.clear();
+            }
+        }
+        polarity.save(choices.begin() + new_choices_from, choices.end());
+        if (config.scc_interval > 0 && node % config.scc_interval == 0) {
+            const EquivalenceBatch *before = equivalences.get();
+            if (!collapseEquivalentLiterals(*current_A, equivalences)) {
+                csPool.release(current_A);
+                continue;
+            }
+            if (equivalences.get() != before) {
+                unit = 0;
+                present.clear();
+            }
+        }
         
-        int i = choice(*current_A);
+        // A unit left by the resolution step is what choice() would return; skip the scan.
+        // Without one, the variables it recorded spare the brancher another pass over A.
+        int i = unit != 0 ? std::abs(unit)
+              : !present.empty() ? brancher->pickPresent(*current_A, present)
+              : brancher->pick(*current_A);
         if (i == 0) {  // Terminal state: no unassigned variables.
-            if (unique_results.insert(choices).second) {
-                results.push_back(choices);
+            if (record(choices, equivalences)) {
                 if (firstAssignment) {
                     csPool.release(current_A);
                     break;
@@ -489,104 +1067,171 @@ std::vector<std::vector<int>> Satisfy_iterative(ClauseSet A, bool firstAssignmen
         
         // Instead of calling ResolutionStep then scanning for conflicts,
         // use ResolutionStepWithConflict to get both the new clause sets and their conflict flags.
-        auto branches = ResolutionStepWithConflict(*current_A, i);
+        auto branches = [&]() {
+            perf::Scope resolution_perf(perf::Resolution, perf::kResolutionSampling);
+            return ResolutionStepWithConflict(*current_A, i, presence_size);
+        }();
+        stats.clauses += current_A->size();
+        stats.bytes += (branches.first.cs.capacity() + branches.second.cs.capacity()) * sizeof(Clause3);
         csPool.release(current_A);  // Release current state as before.
+        // Splitting on a unit always fails on one side; that is propagation, not a conflict.
+        bool forced = unit != 0;
+        ++(forced ? stats.propagations : stats.decisions);
+        if (forced ? branches.first.conflict && branches.second.conflict
+                   : branches.first.conflict || branches.second.conflict) {
+            if (conflict(i, choices, decisions))
+                continue;
+        }
+        unsigned child_decisions = decisions + (forced ? 0 : 1);
         
-        // Process LA branch.
-        {
-            // branchLA conflict flag is set by our new function.
-            if (!branches.first.cs.empty() && !branches.first.conflict) {
-                ClauseSet* newLA = csPool.obtain(branches.first.cs.size());
-                *newLA = std::move(branches.first.cs);
-                std::vector<int> new_choices = choices;
-                new_choices.push_back(i);
-                stack.push_back({newLA, new_choices, branches.first.conflict});
-            } else if (branches.first.cs.empty()) {
-                std::vector<int> new_choices = choices;
-                new_choices.push_back(i);
-                if (unique_results.insert(new_choices).second) {
-                    results.push_back(new_choices);
-                    if (firstAssignment) {
-                        break;  // Found a solution, exit loop.
-                    }
-                }
+        // Push both children; the one pushed last is explored first. A child without
+        // clauses left is a solution. Returns true once the search may stop.
+        auto expand = [&](ClauseSetBranch &branch, int lit) {
+            std::vector<int> new_choices = choices;
+            new_choices.push_back(lit);
+            if (branch.cs.empty())
+                return record(new_choices, equivalences) && firstAssignment;
+            if (!branch.conflict) {
+                ClauseSet* next = csPool.obtain(branch.cs.size());
+                *next = std::move(branch.cs);
+                stack.push_back({next, std::move(new_choices), false, equivalences, branch.unit, child_decisions,
+                                 std::move(branch.present)});
             }
-        }        
-        // Process RA branch.
-        {
-            if (!branches.second.cs.empty() && !branches.second.conflict) {
-                ClauseSet* newRA = csPool.obtain(branches.second.cs.size());
-                *newRA = std::move(branches.second.cs);
-                std::vector<int> new_choices = choices;
-                new_choices.push_back(-i);
-                stack.push_back({newRA, new_choices, branches.second.conflict});
-            } else if (branches.second.cs.empty()) {
-                std::vector<int> new_choices = choices;
-                new_choices.push_back(-i);
-                if (unique_results.insert(new_choices).second) {
-                    results.push_back(new_choices);
-                    if (firstAssignment) {
-                        break;
-                    }
-                }
-            }
-        }
+            return false;
+        };
+        bool stop = polarity.trueFirst(i)
+                  ? expand(branches.second, -i) || expand(branches.first, i)
+                  : expand(branches.first, i) || expand(branches.second, -i);
+        if (stop)
+            break;
         if (found_first_assignment)
             break;
     }
+    worker_stats.add(stats);
+    if (config.node_count)
+        *config.node_count = nodes;
     return results;
 }
 
-std::pair<std::queue<std::pair<ClauseSet, std::vector<int>>>, int> 
-Satisfy_iterative_BFS(ClauseSet A, int max_iterations, int max_tasks, bool override_max_tasks, int &iterations, int max_queues) {
+std::pair<TaskQueue, int> 
+Satisfy_iterative_BFS(const ClauseSet &A, int max_iterations, int max_tasks, bool override_max_tasks, int &iterations, int max_queues,
+                      const std::vector<std::vector<int>> &seed_cubes = {}, const SearchConfig &config = SearchConfig(),
+                      bool cube_tasks = false) {
     PROFILE_SCOPE("Satisfy_iterative_BFS");
-    std::queue<std::pair<ClauseSet, std::vector<int>>> queue;
-    queue.push({A, {}});
+    std::unique_ptr<Brancher> brancher = makeBrancher(config.branching);
+    brancher->start(A);
+    TaskQueue queue;
+    // With cube_tasks the frontier keeps only the choices (O(depth) per task instead of
+    // O(clauses)); a node's clause set is derived from A when it is expanded, and again
+    // by the DFS thread that takes the task.
+    auto push = [&](ClauseSet &&cs, std::vector<int> &&cube) {
+        queue.emplace(cube_tasks ? ClauseSet() : std::move(cs), std::move(cube));
+    };
+    // A node without clauses left is a solution; it replaces the frontier as the only task.
+    auto solved = [&](std::vector<int> cube) {
+        queue = {};
+        queue.emplace(ClauseSet(), std::move(cube));
+        progress.counters.bfs_queue.store(1, std::memory_order_relaxed);
+    };
+    // Start from the root, or from the given cubes (conflicting cubes are dropped).
+    if (seed_cubes.empty())
+        push(ClauseSet(A), {});
+    for (const auto &cube : seed_cubes) {
+        ClauseSetBranch seeded = assignLiterals(A, cube);
+        if (!seeded.conflict)
+            push(std::move(seeded.cs), std::vector<int>(cube));
+    }
     iterations = 0;
-    int task_count = 1;
+    int task_count = static_cast<int>(queue.size());
     while (!queue.empty()) {
         if (max_queues != -1 && queue.size() >= static_cast<size_t>(max_queues))
             break;
         if (max_queues == -1 && !override_max_tasks && task_count >= max_tasks)
             break;
-        auto [current_A, choices] = queue.front();
+        Task current = std::move(queue.front());
         queue.pop();
-        int i = choice(current_A);
-        if (i == 0)
-            continue;
-        auto [LA, RA] = ResolutionStep(current_A, i);
-        {
-            bool conflict = false;
-            for (const auto &cl : LA)
-                if (cl.l[0] == 0 && cl.l[1] == 0 && cl.l[2] == 0) { conflict = true; break; }
-            if (!LA.empty() && !conflict) {
-                std::vector<int> new_choices = choices;
-                new_choices.push_back(i);
-                queue.push({LA, new_choices});
-                task_count++;
-                std::cout << "\r  Queue size: " << queue.size() << " - Depth: " << (iterations + 1)
-                          << " - Tasks: " << task_count << std::flush;
+        ClauseSet &current_A = current.cs;
+        std::vector<int> &choices = current.cube;
+        if (cube_tasks)
+            current_A = assignLiterals(A, choices).cs;
+        int i = brancher->pick(current_A);
+        if (i == 0) {
+            if (!hasEmptyClause(current_A)) {
+                solved(std::move(choices));
+                return {std::move(queue), task_count};
             }
+            continue;
         }
-        {
-            bool conflict = false;
-            for (const auto &cl : RA)
-                if (cl.l[0] == 0 && cl.l[1] == 0 && cl.l[2] == 0) { conflict = true; break; }
-            if (!RA.empty() && !conflict) {
-                std::vector<int> new_choices = choices;
-                new_choices.push_back(-i);
-                queue.push({RA, new_choices});
-                task_count++;
-                std::cout << "\r  Queue size: " << queue.size() << " - Depth: " << (iterations + 1)
-                          << " - Tasks: " << task_count << std::flush;
+        auto branches = ResolutionStepWithConflict(current_A, i);
+        for (auto [branch, lit] : {std::make_pair(&branches.first, i), std::make_pair(&branches.second, -i)}) {
+            std::vector<int> new_choices = choices;
+            new_choices.push_back(lit);
+            if (branch->conflict) {
+                brancher->conflict(i, choices);
+                continue;
+            }
+            if (branch->cs.empty()) {
+                solved(std::move(new_choices));
+                return {std::move(queue), ++task_count};
             }
+            push(std::move(branch->cs), std::move(new_choices));
+            task_count++;
         }
         iterations++;
+        progress.counters.bfs_queue.store(queue.size(), std::memory_order_relaxed);
+        progress.counters.bfs_depth.store(iterations, std::memory_order_relaxed);
+        progress.counters.bfs_tasks.store(task_count, std::memory_order_relaxed);
         if (max_queues == -1 && iterations >= max_iterations)
             break;
     }
-    std::cout << std::endl;
-    return {queue, task_count};
+    return {std::move(queue), task_count};
+}
+
+// Streaming counterpart of Satisfy_iterative_BFS: expands the formula depth-first and
+// pushes every node as a task into `out` as soon as it has made `depth` two-way splits
+// (forced splits, where one side conflicts, do not count), so at most 2^depth tasks.
+// Solution nodes are pushed right away. Closes `out` when done; stops if it is cancelled.
+void streamTasks(const ClauseSet &A, int depth, const std::vector<std::vector<int>> &seed_cubes,
+                 const SearchConfig &config, bool cube_tasks, BoundedTaskQueue &out) {
+    PROFILE_SCOPE("streamTasks");
+    std::unique_ptr<Brancher> brancher = makeBrancher(config.branching);
+    brancher->start(A);
+    std::vector<std::pair<Task, int>> stack;   // node, two-way splits so far
+    if (seed_cubes.empty())
+        stack.emplace_back(Task(A, {}), 0);
+    for (auto it = seed_cubes.rbegin(); it != seed_cubes.rend(); ++it) {
+        ClauseSetBranch seeded = assignLiterals(A, *it);
+        if (!seeded.conflict)
+            stack.emplace_back(Task(std::move(seeded.cs), *it), 0);
+    }
+    auto emit = [&](Task &&task) {
+        if (cube_tasks)
+            task.cs = ClauseSet();
+        return out.push(std::move(task));
+    };
+    while (!stack.empty() && !out.cancelled()) {
+        Task current = std::move(stack.back().first);
+        int splits = stack.back().second;
+        stack.pop_back();
+        int i = splits < depth ? brancher->pick(current.cs) : 0;
+        if (i == 0) {   // target depth reached, or no variable left (a solution)
+            if (!hasEmptyClause(current.cs) && !emit(std::move(current)))
+                break;
+            continue;
+        }
+        auto branches = ResolutionStepWithConflict(current.cs, i);
+        int two_way = !branches.first.conflict && !branches.second.conflict;
+        if (!two_way)
+            brancher->conflict(i, current.cube);
+        for (auto [branch, lit] : {std::make_pair(&branches.second, -i), std::make_pair(&branches.first, i)}) {
+            if (branch->conflict)
+                continue;
+            std::vector<int> cube = current.cube;
+            cube.push_back(lit);
+            stack.emplace_back(Task(std::move(branch->cs), std::move(cube)), splits + two_way);
+        }
+    }
+    out.close();
 }
 
 
@@ -615,6 +1260,135 @@ void ExtractInputsFromDimacs(const std::string& dimacsString, std::vector<int>&
     }
 }
 
+// === Factoring-Specific Constraints ===
+
+// Builds clauses over the factor input variables into a ClauseStore. Literal 0 stands
+// for the constant false (e.g. the zero-extended bits of the narrower factor): it is
+// dropped from clauses, and its negation satisfies the clause.
+struct FactorClauseBuilder {
+    ClauseStore &store;
+    int next_var;
+
+    FactorClauseBuilder(ClauseStore &s, int num_vars) : store(s), next_var(std::max(num_vars, s.max_var) + 1) { }
+
+    int fresh() { return next_var++; }
+
+    void add(std::initializer_list<int> lits) {
+        std::vector<int> clause;
+        for (int lit : lits) {
+            if (lit == FALSE_LIT) continue;
+            if (lit == TRUE_LIT) return;
+            clause.push_back(lit);
+        }
+        store.addClause(clause.data(), clause.data() + clause.size());
+    }
+    void add(const std::vector<int> &lits) {
+        std::vector<int> clause;
+        for (int lit : lits) {
+            if (lit == FALSE_LIT) continue;
+            if (lit == TRUE_LIT) return;
+            clause.push_back(lit);
+        }
+        store.addClause(clause.data(), clause.data() + clause.size());
+    }
+
+    static constexpr int FALSE_LIT = 0;
+    static constexpr int TRUE_LIT = INT_MIN;
+    static int negate(int lit) { return lit == FALSE_LIT ? TRUE_LIT : lit == TRUE_LIT ? FALSE_LIT : -lit; }
+};
+
+// Zero-extend an [msb,...,lsb] variable list to `width` bits (constant false on top).
+std::vector<int> zeroExtend(const std::vector<int>& bits, std::size_t width) {
+    std::vector<int> out(width > bits.size() ? width - bits.size() : 0, FactorClauseBuilder::FALSE_LIT);
+    out.insert(out.end(), bits.begin(), bits.end());
+    return out;
+}
+
+// Symmetry breaking for N = p * q: swapping the two input words maps solutions onto
+// solutions, so we require narrower <= wider (factor1 <= factor2 for equal widths) with
+// a lexicographic comparator over msb -> lsb. e_i ("bits 1..i equal so far") only needs
+// the forcing direction:
+//     e_{i-1} -> (a_i <= b_i)               (-e_{i-1} -a_i b_i)
+//     e_{i-1} & (a_i | -b_i) -> e_i          (-e_{i-1} -a_i e_i) (-e_{i-1} b_i e_i)
+// Both factors are also required to differ from 1. Returns the number of clauses added.
+std::size_t addFactorSymmetryBreaking(ClauseStore &store, int num_vars, const std::vector<int>& v1, const std::vector<int>& v2) {
+    PROFILE_SCOPE("addFactorSymmetryBreaking");
+    if (v1.empty() || v2.empty())
+        return 0;
+    std::size_t before = store.size();
+    FactorClauseBuilder builder(store, num_vars);
+    const std::size_t width = std::max(v1.size(), v2.size());
+    const bool swap = v1.size() > v2.size();
+    std::vector<int> a = zeroExtend(swap ? v2 : v1, width);
+    std::vector<int> b = zeroExtend(swap ? v1 : v2, width);
+
+    int prefix_equal = FactorClauseBuilder::TRUE_LIT;
+    for (std::size_t i = 0; i < width; ++i) {
+        int not_e = FactorClauseBuilder::negate(prefix_equal);
+        int not_a = FactorClauseBuilder::negate(a[i]);
+        builder.add({not_e, not_a, b[i]});
+        if (i + 1 == width)
+            break;
+        int e = builder.fresh();
+        builder.add({not_e, not_a, e});
+        builder.add({not_e, b[i], e});
+        prefix_equal = e;
+    }
+
+    // factor != 1: some bit above the lsb is set, or the lsb is clear.
+    for (const std::vector<int>* factor : {&v1, &v2}) {
+        std::vector<int> clause(factor->begin(), factor->end() - 1);
+        clause.push_back(-factor->back());
+        builder.add(clause);
+    }
+    return store.size() - before;
+}
+
+// Low-order bits of N = p * q: the low k bits of p * q must equal N mod 2^k, so only few
+// (p mod 2^k, q mod 2^k) pairs are admissible (for odd N: p, q odd and q fixed by p).
+// Bits shared by all admissible pairs are returned in `fixed` (e.g. both lsbs = 1 for
+// odd N); the remaining bits of each pair form one cube in `cubes`. k is capped by the
+// narrower input and by 12 (the pairs are enumerated exhaustively); returns the k used.
+int lowBitCubes(const big_int& N, const std::vector<int>& v1, const std::vector<int>& v2, int k,
+                std::vector<int>& fixed, std::vector<std::vector<int>>& cubes) {
+    PROFILE_SCOPE("lowBitCubes");
+    k = std::min<int>({k, 12, static_cast<int>(v1.size()), static_cast<int>(v2.size())});
+    if (k <= 0)
+        return 0;
+    const unsigned mask = (1u << k) - 1;
+    big_int low = N & big_int(mask);
+    const unsigned target = static_cast<unsigned>(low.get_ui());
+    std::vector<std::pair<unsigned, unsigned>> pairs;
+    for (unsigned x = 0; x <= mask; ++x)
+        for (unsigned y = 0; y <= mask; ++y)
+            if (((x * y) & mask) == target)
+                pairs.emplace_back(x, y);
+
+    // Literal of bit j (0 = lsb) of a factor given its [msb,...,lsb] variables.
+    auto lit = [](const std::vector<int>& v, int j, unsigned value) {
+        int var = v[v.size() - 1 - j];
+        return ((value >> j) & 1) ? var : -var;
+    };
+    std::vector<int> open;   // 0..k-1: bits of p, k..2k-1: bits of q
+    for (int b = 0; b < 2 * k; ++b) {
+        auto bit = [&](const std::pair<unsigned, unsigned>& pr) { return b < k ? (pr.first >> b) & 1 : (pr.second >> (b - k)) & 1; };
+        bool same = std::all_of(pairs.begin(), pairs.end(), [&](const auto& pr) { return bit(pr) == bit(pairs[0]); });
+        if (same)
+            fixed.push_back(b < k ? lit(v1, b, pairs[0].first) : lit(v2, b - k, pairs[0].second));
+        else
+            open.push_back(b);
+    }
+    if (open.empty())
+        return k;
+    for (const auto& pr : pairs) {
+        std::vector<int> cube;
+        for (int b : open)
+            cube.push_back(b < k ? lit(v1, b, pr.first) : lit(v2, b - k, pr.second));
+        cubes.push_back(std::move(cube));
+    }
+    return k;
+}
+
 std::string mpz_to_string(const mpz_class& num) {
     PROFILE_SCOPE("mpz_to_string");
     return num.get_str();
@@ -680,6 +1454,52 @@ std::string formatFilename(const std::string& script_name, const std::string& fi
     return ss.str();
 }
 
+// Summary lines of the search statistics, summed over the DFS threads and per thread.
+std::string formatSearchStats(double dfs_seconds) {
+    PROFILE_SCOPE("formatSearchStats");
+    auto rate = [dfs_seconds](std::uint64_t n) { return dfs_seconds > 0 ? static_cast<std::uint64_t>(n / dfs_seconds) : 0; };
+    auto workers = progress.workerTotals();
+    SearchStats sum;
+    for (const auto &worker : workers)
+        sum.add(worker.second);
+    std::stringstream ss;
+    ss << "       Nodes: " << sum.nodes << " (" << rate(sum.nodes) << " nodes/s)" << std::endl;
+    ss << "   Conflicts: " << sum.conflicts << " (" << rate(sum.conflicts) << " conflicts/s)" << std::endl;
+    ss << "   Decisions: " << sum.decisions << " - Propagations: " << sum.propagations << std::endl;
+    ss << "   Max depth: " << sum.max_depth << std::endl;
+    ss << "  Resolution: " << sum.clauses << " clauses scanned - " << sum.bytes / (1024 * 1024) << " MB allocated" << std::endl;
+    for (const auto &worker : workers)
+        ss << "   Thread " << std::setw(3) << worker.first << ": " << worker.second.nodes << " nodes (" << rate(worker.second.nodes)
+           << "/s) - " << worker.second.conflicts << " conflicts (" << rate(worker.second.conflicts) << "/s) - max depth "
+           << worker.second.max_depth << std::endl;
+    return ss.str();
+}
+
+// Summary line of the per-task solve times, e.g. "p50 0.01 s - p90 0.2 s - p99 1.5 s - max 3 s (276 tasks)".
+std::string formatTaskTimes() {
+    PROFILE_SCOPE("formatTaskTimes");
+    profiling::LogHistogram h = task_times.histogram();
+    std::stringstream ss;
+    ss << "p50 " << h.percentile(0.50) * 1e-9 << " s - p90 " << h.percentile(0.90) * 1e-9
+       << " s - p99 " << h.percentile(0.99) * 1e-9 << " s - max " << h.max() * 1e-9 << " s (" << h.count() << " tasks)";
+    return ss.str();
+}
+
+// Summary line of the huge page regions, empty with --hugepages off.
+std::string formatHugePages() {
+    auto &regions = hugepages::Regions::instance();
+    if (regions.mode() == hugepages::Mode::Off)
+        return "";
+    auto totals = regions.totals();
+    std::stringstream ss;
+    ss << "  Huge pages: " << hugepages::modeName(regions.mode()) << " - ";
+    if (regions.mode() == hugepages::Mode::Hugetlb)
+        ss << totals.hugetlb << " hugetlb, ";
+    ss << totals.thp << " THP, " << totals.fallbacks << " 4 KB regions - peak "
+       << totals.peak_bytes / (1024 * 1024) << " MB" << std::endl;
+    return ss.str();
+}
+
 void exportResultsToFile(const std::string& filename, const std::string& content) {
     PROFILE_SCOPE("exportResultsToFile");
     std::ofstream outFile(filename);
@@ -688,211 +1508,307 @@ void exportResultsToFile(const std::string& filename, const std::string& content
 }
 
 
-std::vector<std::vector<int>> process_queue(
-    std::queue<std::pair<ClauseSet, std::vector<int>>> queue, 
-    bool parallel, big_int input_number, int num_bits, int num_vars, int num_clauses, 
-    std::vector<int>& v1, std::vector<int>& v2, 
-    std::chrono::high_resolution_clock::time_point bfs_start, 
-    std::chrono::high_resolution_clock::time_point dfs_start, 
-    int num_threads, int task_count, const std::string& script_name, 
-    const std::string& filename, const std::string& cli_flag, int reserve_cores, 
-    const std::string& output_directory, bool override_max_tasks, int iterations, int total_cores) 
+void exportTaskTimes() {
+    if (task_times.path().empty())
+        return;
+    if (task_times.exportCsv())
+        std::cout << "Task times saved: " << task_times.path() << std::endl;
+    else
+        std::cerr << "\nError: Could not write task times to " << task_times.path() << std::endl;
+}
+
+void exportTrace() {
+    if (!trace.enabled())
+        return;
+    if (trace.write())
+        std::cout << "Trace saved: " << trace.path() << std::endl;
+    else
+        std::cerr << "\nError: Could not write trace " << trace.path() << std::endl;
+}
+
+// What process_queue found: the first solution (BFS cube + DFS choices; empty if every
+// task was searched without one), who found it and when the DFS ended.
+struct DfsResult {
+    std::vector<std::vector<int>> final_choices;
+    int thread = -1;
+    std::string portfolio_config;   // configuration of the finding thread in portfolio mode
+    int threads = 0;                // DFS threads that ran
+    std::size_t queue_size = 0;     // tasks queued when the DFS started
+    int tasks = 0;                  // tasks in total, streamed ones included
+    std::chrono::high_resolution_clock::time_point end;
+};
+
+// Searches the BFS tasks on all OpenMP threads until the first solution or until every
+// task is done; the caller reports the result.
+DfsResult process_queue(
+    TaskQueue queue, int num_threads, int task_count,
+    const SearchConfig& search_config = SearchConfig(), const std::vector<SearchConfig>& portfolio = {},
+    CheckpointWriter* checkpoint = nullptr, const ClauseSet* cube_root = nullptr,
+    BoundedTaskQueue* stream = nullptr) 
 {
     PROFILE_SCOPE("process_queue");
-    std::vector<std::vector<int>> final_choices;
+    DfsResult result;
     std::mutex queue_mutex;
     std::condition_variable cv;
     std::atomic<bool> found(false);
     std::atomic<int> thread_count(0);
     size_t initial_queue_size = queue.size();
-    bool first_change_skipped = false;
-
-    if (parallel) {
-        std::chrono::duration<double> bfs_duration = dfs_start - bfs_start;
-        std::cout << "\n    BFS time: " << bfs_duration.count() << " seconds  -  DFS parallel initiated..\n" << std::endl;
-        auto start_time = std::chrono::high_resolution_clock::now();
-
-		std::thread time_printer([&]() {
-			PROFILE_SCOPE("time_printer");
-			size_t prev_queue_size = queue.size();
-			auto last_change_time = std::chrono::high_resolution_clock::now();
-			bool first_change_skipped = false;
-		
-			while (!found.load()) {
-				auto now = std::chrono::high_resolution_clock::now();
-				auto total_elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start_time);
-				std::cout << "\033[2K\r    DFS time: " << total_elapsed.count() << " seconds"
-						  << " - Remaining Queue Size: " << queue.size()
-						  << std::flush;
-				size_t current_queue_size = queue.size();
-				if (current_queue_size != prev_queue_size) {
-					if (!first_change_skipped) {
-						first_change_skipped = true;
-					} else {
-						auto lap_elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - last_change_time);
-						std::cout << "\n    Lap time: " << prev_queue_size << " = " << lap_elapsed.count() << " seconds\n"
-								  << std::endl;
-					}
-					prev_queue_size = current_queue_size;
-					last_change_time = now;
-				}
-				std::this_thread::sleep_for(std::chrono::seconds(1));
-			}
-		});
-        #pragma omp parallel shared(queue, final_choices, queue_mutex, found, thread_count, cv)
-        {
-            #pragma omp single
-            thread_count.store(omp_get_num_threads());
+    // Streaming mode: tasks arrive in `stream` while the BFS is still running.
+    auto tasks_total = [&]() { return stream ? static_cast<int>(stream->pushed()) : task_count; };
+    // Task k is the k-th queue entry. Finished = searched completely without a solution;
+    // portfolio threads skip tasks another thread has finished.
+    // Streamed tasks are not numbered (id >= task_finished.size()) and have one searcher each.
+    // Returns false if another thread finished the task first.
+    std::vector<std::atomic<bool>> task_finished(initial_queue_size);
+    auto finish = [&](std::size_t id) {
+        if (id >= task_finished.size()) {
+            progress.counters.dfs_finished.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (task_finished[id].exchange(true))
+            return false;
+        progress.counters.dfs_finished.fetch_add(1, std::memory_order_relaxed);
+        if (checkpoint)
+            checkpoint->finished(id);
+        return true;
+    };
+    std::size_t next_queued = 0;
+    std::atomic<long long> stream_popped(0);
+    // Portfolio mode: every thread works through all tasks with its own configuration.
+    std::vector<Task> portfolio_tasks;
+    if (!portfolio.empty())
+        for (; !queue.empty(); queue.pop())
+            portfolio_tasks.push_back(std::move(queue.front()));
+    // Pinned workers: one queue per NUMA node, task k goes to the node of worker k mod threads
+    // (so every node gets its share of the tasks); tasks keep their queue position as ID.
+    std::unique_ptr<numa::NodeQueues<std::pair<std::size_t, Task>>> node_queues;
+    if (placement.enabled() && portfolio.empty() && !stream) {
+        node_queues = std::make_unique<numa::NodeQueues<std::pair<std::size_t, Task>>>(placement.nodes());
+        for (std::size_t k = 0; !queue.empty(); queue.pop(), ++k)
+            node_queues->push(placement.node(static_cast<int>(k % std::max(num_threads, 1))), {k, std::move(queue.front())});
+    }
 
-            while (true) {
-                std::pair<ClauseSet, std::vector<int>> current_task;
-                {
-                    std::unique_lock<std::mutex> lock(queue_mutex);
-                    if (!queue.empty() && !found.load()) {
-                        current_task = queue.front();
-                        queue.pop();
-                        cv.notify_one();
-                    } else break;
-                }
+    // The reporter thread prints the DFS progress (and writes due checkpoints) from here on.
+    std::size_t pending = !portfolio.empty() ? portfolio_tasks.size() : stream ? stream->size()
+                        : node_queues ? node_queues->size() : queue.size();
+    progress.counters.dfs_pending.store(pending, std::memory_order_relaxed);
+    progress.phase(ProgressReporter::Phase::Dfs);
+    if (checkpoint)
+        progress.onSample([checkpoint, failed = false]() mutable {
+            if (!checkpoint->tick() && !failed) {
+                failed = true;
+                std::cerr << "\nError: Could not write checkpoint " << checkpoint->path() << std::endl;
+            }
+        });
+    #pragma omp parallel shared(queue, result, queue_mutex, found, thread_count, cv)
+    {
+        #pragma omp single
+        thread_count.store(omp_get_num_threads());
+        SearchConfig worker_config = search_config;
+        if (!portfolio.empty())
+            worker_config = portfolio[omp_get_thread_num() % portfolio.size()];
+        else
+            worker_config.polarity = polarityForWorker(search_config.polarity, omp_get_thread_num());
+        worker_config.cancel = &found;
+        std::size_t next_task = 0;
+        std::size_t task_nodes = 0;
+        worker_config.node_count = &task_nodes;
+        // The trace shows every search of a task; the task times only the first that finished
+        // it, so portfolio runs do not count one task once per thread.
+        auto record_task = [&](long long task, std::size_t cube, std::chrono::steady_clock::time_point start, const char *outcome,
+                               bool first) {
+            auto end = std::chrono::steady_clock::now();
+            std::chrono::duration<double> took = end - start;
+            if (first)
+                task_times.record({task, omp_get_thread_num(), cube, took.count(), outcome});
+            Trace::Event event{"task", "dfs", omp_get_thread_num(), start, end};
+            event.task = task;
+            event.cube = static_cast<long long>(cube);
+            event.nodes = static_cast<long long>(task_nodes);
+            event.result = outcome;
+            trace.record(event);
+        };
+        trace.nameThread(omp_get_thread_num(), omp_get_thread_num() == 0 ? "main, DFS 0" : "DFS " + std::to_string(omp_get_thread_num()));
 
-                auto [v_i, c_i] = current_task;
-                auto new_choices = Satisfy_iterative(v_i, true);
-                for (const auto& nc : new_choices) {
-                    std::vector<int> final_choices_i = c_i;
-                    final_choices_i.insert(final_choices_i.end(), nc.begin(), nc.end());
-                    #pragma omp critical
-                    {
-                        if (!found.load()) {
-                            final_choices.push_back(final_choices_i);
-                            auto dfs_end = std::chrono::high_resolution_clock::now();
-                            found.store(true);
-                            dfs_running = false;
-                            cv.notify_one();
-                            time_printer.join();
-                            
-                            std::ostringstream output_ss;
-                            output_ss << "\n              Thread " << omp_get_thread_num() << " found a solution!\n" << std::endl;
-                            std::chrono::duration<double> dfs_duration = dfs_end - dfs_start;
-                            std::chrono::duration<double> ndp_duration = dfs_end - bfs_start;
-                            auto [d1, d2] = convert(final_choices, v1, v2);
-                            output_ss << "        Bits: " << num_bits;
-                            output_ss << "\n        VARs: " << num_vars;
-                            output_ss << "\n     Clauses: " << num_clauses;
-                            output_ss << "\n\nInput Number: " << input_number << std::endl;
-                            output_ss << "      FACT 1: " << d1 << std::endl;
-                            output_ss << "      FACT 2: " << d2 << std::endl;
-                            output_ss << (d1 * d2 == input_number ? "              verified." : "              FALSE") << std::endl;
-                            output_ss << "\n    BFS time: " << bfs_duration.count() << " seconds (" 
-                                      << formatPercentage(bfs_duration.count(), ndp_duration.count()) << ")" << std::endl;
-                            output_ss << "              " << formatDuration(bfs_duration.count()) << std::endl;
-                            output_ss << "    DFS time: " << dfs_duration.count() << " seconds (" 
-                                      << formatPercentage(dfs_duration.count(), ndp_duration.count()) << ")" << std::endl;
-                            output_ss << "              " << formatDuration(dfs_duration.count()) << std::endl;
-                            output_ss << "    NDP time: " << ndp_duration.count() << " seconds" << std::endl;
-                            output_ss << "              " << formatDuration(ndp_duration.count()) << std::endl;
-                            output_ss << " Total Cores: " << total_cores << std::endl;
-                            output_ss << "   NDP Cores: " << num_threads << std::endl;
-                            output_ss << " DFS Threads: " << thread_count.load() << std::endl;
-                            output_ss << "  Queue Size: " << initial_queue_size << std::endl;
-                            output_ss << "       Depth: " << iterations << std::endl;
-                            output_ss << "       Tasks: " << task_count << std::endl;
-                            output_ss << version << std::endl;
-                            output_ss << "      DIMACS: " << filename << std::endl;
-                            std::string utcTime = getCurrentUTCTime();
-                            output_ss << "   Zulu time: " << utcTime << std::endl;
-                            std::string problemID = createProblemID(mpz_to_string(input_number), num_bits, num_threads, utcTime);
-                            output_ss << "  Problem ID: " << problemID << std::endl;
-                            output_ss << "\n";
-
-                            std::cout << output_ss.str();
-                            
-							output_ss << "\n Assignments:";
-							if (final_choices.empty()) {
-								output_ss << " none";
-							} else {
-								for (const auto& solution : final_choices) {
-									for (int val : solution) {
-										output_ss << " " << val;
-									}
-								}
-							}
-                            std::string input_filename_only = std::filesystem::path(filename).filename().string();
-                            std::string output_filename = formatFilename(script_name, input_filename_only, problemID, cli_flag, reserve_cores);
-                            std::string full_output_path = output_directory + "/" + output_filename;
-                            exportResultsToFile(full_output_path, output_ss.str());
-                            std::cout << "Result saved: " << full_output_path << std::endl;
-                            std::cout << "\n" << std::endl;
-                            dumpProfilingResults();                            
-                            std::terminate();
-                        }
+        while (true) {
+            Task current_task;
+            std::size_t task_id;
+            long long task_number;   // for the task times, also in streaming mode
+            if (!portfolio.empty()) {
+                while (next_task < portfolio_tasks.size() && task_finished[next_task].load())
+                    ++next_task;
+                if (next_task >= portfolio_tasks.size() || found.load())
+                    break;
+                task_id = next_task++;
+                task_number = task_id;
+                if (omp_get_thread_num() == 0)
+                    progress.counters.dfs_pending.store(portfolio_tasks.size() - next_task, std::memory_order_relaxed);
+                // Every portfolio thread searches the task, so each takes its own copy.
+                current_task = Task(portfolio_tasks[task_id].cs, portfolio_tasks[task_id].cube);
+            } else if (stream) {
+                if (found.load() || !stream->pop(current_task))
+                    break;
+                progress.counters.dfs_pending.store(stream->size(), std::memory_order_relaxed);
+                task_id = task_finished.size();   // not numbered: no checkpoint in streaming mode
+                task_number = stream_popped.fetch_add(1);
+            } else if (node_queues) {
+                std::pair<std::size_t, Task> queued;
+                if (found.load() || !node_queues->pop(placement.node(omp_get_thread_num()), queued))
+                    break;
+                task_id = queued.first;
+                task_number = task_id;
+                current_task = std::move(queued.second);
+                progress.counters.dfs_pending.store(node_queues->size(), std::memory_order_relaxed);
+            } else {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                if (!queue.empty() && !found.load()) {
+                    current_task = std::move(queue.front());
+                    queue.pop();
+                    task_id = next_queued++;
+                    task_number = task_id;
+                    progress.counters.dfs_pending.store(queue.size(), std::memory_order_relaxed);
+                    cv.notify_one();
+                } else break;
+            }
+
+            ClauseSet &v_i = current_task.cs;
+            const std::vector<int> &c_i = current_task.cube;
+            auto task_start = std::chrono::steady_clock::now();
+            task_nodes = 0;
+            perf::Scope task_perf(perf::DfsTask);
+            // The BFS (OpenMP thread 0) allocated the clause set; copy it onto this worker's node.
+            if (node_queues && placement.node(omp_get_thread_num()) != placement.node(0))
+                v_i = ClauseSet(v_i);
+            if (cube_root) {   // cube-only task: derive its clause set from the shared formula
+                ClauseSetBranch derived = assignLiterals(*cube_root, c_i);
+                if (derived.conflict) {
+                    record_task(task_number, c_i.size(), task_start, "conflict", finish(task_id));
+                    continue;
+                }
+                v_i = std::move(derived.cs);
+            }
+            auto new_choices = Satisfy_iterative(std::move(v_i), true, worker_config);
+            task_perf.stop();   // the search only, not the solution bookkeeping below
+            // An empty result is only a finished task if the search was not cancelled.
+            if (new_choices.empty() && !found.load()) {
+                record_task(task_number, c_i.size(), task_start, "unsat", finish(task_id));
+            }
+            for (const auto& nc : new_choices) {
+                std::vector<int> final_choices_i = c_i;
+                final_choices_i.insert(final_choices_i.end(), nc.begin(), nc.end());
+                #pragma omp critical
+                {
+                    if (!found.load()) {
+                        result.final_choices.push_back(final_choices_i);
+                        result.end = std::chrono::high_resolution_clock::now();
+                        result.thread = omp_get_thread_num();
+                        if (!portfolio.empty())
+                            result.portfolio_config = describeSearchConfig(worker_config);
+                        record_task(task_number, c_i.size(), task_start, "solution", true);
+                        found.store(true);
+                        if (stream)
+                            stream->cancel();
                     }
-                    if (found.load()) break;
                 }
-                
                 if (found.load()) break;
             }
-        }
-        if (final_choices.empty()) {
-            auto dfs_end = std::chrono::high_resolution_clock::now();
-            dfs_running = false;
-            cv.notify_one();
-            time_printer.join();
             
-            std::chrono::duration<double> dfs_duration = dfs_end - dfs_start;
-            std::chrono::duration<double> ndp_duration = dfs_end - bfs_start;
-            std::cout << " DFS Threads: " << thread_count.load() << std::endl;
-            std::cout << "    DFS time: " << dfs_duration.count() << " seconds" << std::endl;
-            std::ostringstream output_ss;
-            output_ss << "\n        Bits: " << num_bits;
-            output_ss << "\n        VARs: " << num_vars;
-            output_ss << "\n     Clauses: " << num_clauses;
-            output_ss << "\n\nInput Number: " << input_number << std::endl;
-            output_ss << "              Prime!\n" << std::endl;
-            output_ss << "    BFS time: " << bfs_duration.count() << " seconds (" 
-                      << formatPercentage(bfs_duration.count(), ndp_duration.count()) << ")" << std::endl;
-            output_ss << "              " << formatDuration(bfs_duration.count()) << std::endl;
-            output_ss << "    DFS time: " << dfs_duration.count() << " seconds (" 
-                      << formatPercentage(dfs_duration.count(), ndp_duration.count()) << ")" << std::endl;
-            output_ss << "              " << formatDuration(dfs_duration.count()) << std::endl;
-            output_ss << "    NDP time: " << ndp_duration.count() << " seconds" << std::endl;
-            output_ss << "              " << formatDuration(ndp_duration.count()) << std::endl;
-            output_ss << " Total Cores: " << total_cores << std::endl;
-            output_ss << "   NDP Cores: " << num_threads << std::endl;
-            output_ss << " DFS Threads: " << thread_count.load() << std::endl;
-            output_ss << "  Queue Size: " << initial_queue_size << std::endl;
-            output_ss << "       Depth: " << iterations << std::endl;
-            output_ss << "       Tasks: " << task_count << std::endl;
-            output_ss << version << std::endl;
-            output_ss << "      DIMACS: " << filename << std::endl;
-            std::string utcTime = getCurrentUTCTime();
-            output_ss << "   Zulu time: " << utcTime << std::endl;
-            std::string problemID = createProblemID(mpz_to_string(input_number), num_bits, num_threads, utcTime);
-            output_ss << "  Problem ID: " << problemID << std::endl;
-			output_ss << "\n";
-
-            std::cout << output_ss.str();
-
-			output_ss << "\n Assignments:";
-			if (final_choices.empty()) {
-				output_ss << " none";
-			} else {
-				for (const auto& solution : final_choices) {
-					for (int val : solution) {
-						output_ss << " " << val;
-					}
-				}
-			}
-            std::string input_filename_only = std::filesystem::path(filename).filename().string();
-            std::string output_filename = formatFilename(script_name, input_filename_only, problemID, cli_flag, reserve_cores);
-            std::string full_output_path = output_directory + "/" + output_filename;
-            exportResultsToFile(full_output_path, output_ss.str());
-            std::cout << "Result saved: " << full_output_path << std::endl;
-            std::cout << "\n" << std::endl;
-            dumpProfilingResults();
-            std::terminate();
-        }
-    }
-    return final_choices;
+            if (found.load()) break;
+        }
+    }
+    if (result.final_choices.empty())
+        result.end = std::chrono::high_resolution_clock::now();
+    dfs_running = false;
+    cv.notify_one();
+    progress.stop();
+    result.threads = thread_count.load();
+    result.queue_size = initial_queue_size;
+    result.tasks = tasks_total();
+    return result;
+}
+
+// Prints the summary of a run (the factors, or Prime! if process_queue found no solution),
+// saves it with the assignments to the output directory and writes the task times and the trace.
+void reportResult(const DfsResult& result, const big_int& input_number, int num_bits, int num_vars, int num_clauses,
+                  std::vector<int>& v1, std::vector<int>& v2,
+                  std::chrono::high_resolution_clock::time_point bfs_start,
+                  std::chrono::high_resolution_clock::time_point dfs_start,
+                  int num_threads, const std::string& script_name, const std::string& filename,
+                  const std::string& cli_flag, int reserve_cores, const std::string& output_directory,
+                  int iterations, int total_cores)
+{
+    PROFILE_SCOPE("reportResult");
+    const std::vector<std::vector<int>>& final_choices = result.final_choices;
+    std::chrono::duration<double> bfs_duration = dfs_start - bfs_start;
+    std::chrono::duration<double> dfs_duration = result.end - dfs_start;
+    std::chrono::duration<double> ndp_duration = result.end - bfs_start;
+    std::ostringstream output_ss;
+    if (!final_choices.empty()) {
+        output_ss << "\n              Thread " << result.thread << " found a solution!\n" << std::endl;
+        if (!result.portfolio_config.empty())
+            output_ss << "   Portfolio: " << result.portfolio_config << "\n" << std::endl;
+        auto [d1, d2] = convert(final_choices, v1, v2);
+        output_ss << "        Bits: " << num_bits;
+        output_ss << "\n        VARs: " << num_vars;
+        output_ss << "\n     Clauses: " << num_clauses;
+        output_ss << "\n\nInput Number: " << input_number << std::endl;
+        output_ss << "      FACT 1: " << d1 << std::endl;
+        output_ss << "      FACT 2: " << d2 << std::endl;
+        output_ss << (d1 * d2 == input_number ? "              verified." : "              FALSE") << std::endl;
+        output_ss << "\n";
+    } else {
+        std::cout << " DFS Threads: " << result.threads << std::endl;
+        std::cout << "    DFS time: " << dfs_duration.count() << " seconds" << std::endl;
+        output_ss << "\n        Bits: " << num_bits;
+        output_ss << "\n        VARs: " << num_vars;
+        output_ss << "\n     Clauses: " << num_clauses;
+        output_ss << "\n\nInput Number: " << input_number << std::endl;
+        output_ss << "              Prime!\n" << std::endl;
+    }
+    output_ss << "    BFS time: " << bfs_duration.count() << " seconds (" 
+              << formatPercentage(bfs_duration.count(), ndp_duration.count()) << ")" << std::endl;
+    output_ss << "              " << formatDuration(bfs_duration.count()) << std::endl;
+    output_ss << "    DFS time: " << dfs_duration.count() << " seconds (" 
+              << formatPercentage(dfs_duration.count(), ndp_duration.count()) << ")" << std::endl;
+    output_ss << "              " << formatDuration(dfs_duration.count()) << std::endl;
+    output_ss << "    NDP time: " << ndp_duration.count() << " seconds" << std::endl;
+    output_ss << "              " << formatDuration(ndp_duration.count()) << std::endl;
+    output_ss << " Total Cores: " << total_cores << std::endl;
+    output_ss << "   NDP Cores: " << num_threads << std::endl;
+    output_ss << " DFS Threads: " << result.threads << std::endl;
+    output_ss << "  Queue Size: " << result.queue_size << std::endl;
+    output_ss << "       Depth: " << iterations << std::endl;
+    output_ss << "       Tasks: " << result.tasks << std::endl;
+    output_ss << "  Task times: " << formatTaskTimes() << std::endl;
+    output_ss << formatHugePages();
+    output_ss << formatSearchStats(dfs_duration.count());
+    output_ss << version << std::endl;
+    output_ss << "      DIMACS: " << filename << std::endl;
+    std::string utcTime = getCurrentUTCTime();
+    output_ss << "   Zulu time: " << utcTime << std::endl;
+    std::string problemID = createProblemID(mpz_to_string(input_number), num_bits, num_threads, utcTime);
+    output_ss << "  Problem ID: " << problemID << std::endl;
+    output_ss << "\n";
+
+    std::cout << output_ss.str();
+
+    output_ss << "\n Assignments:";
+    if (final_choices.empty()) {
+        output_ss << " none";
+    } else {
+        for (const auto& solution : final_choices) {
+            for (int val : solution) {
+                output_ss << " " << val;
+            }
+        }
+    }
+    std::string input_filename_only = std::filesystem::path(filename).filename().string();
+    std::string output_filename = formatFilename(script_name, input_filename_only, problemID, cli_flag, reserve_cores);
+    std::string full_output_path = output_directory + "/" + output_filename;
+    exportResultsToFile(full_output_path, output_ss.str());
+    std::cout << "Result saved: " << full_output_path << std::endl;
+    exportTaskTimes();
+    exportTrace();
 }
 
 std::string readFileToString(const std::string& filename) {
@@ -907,6 +1823,37 @@ std::string readFileToString(const std::string& filename) {
     return oss.str();
 }
 
+// Generator mode: --generate bits[:seed] [-o output_directory] writes rsaFACT-<bits>bit-<seed>.dimacs
+// for a random semiprime of that bit width and exits.
+int generateFactoringCnf(int argc, char* argv[]) {
+    PROFILE_SCOPE("generateFactoringCnf");
+    if (argc < 3) { std::cerr << "\nError: Missing argument for --generate option.\n"; return 1; }
+    int bits = 0;
+    unsigned long seed = 1;
+    std::string spec = argv[2], output_directory = getWorkingDirectory();
+    try {
+        std::size_t colon = spec.find(':');
+        bits = std::stoi(spec.substr(0, colon));
+        if (colon != std::string::npos)
+            seed = std::stoul(spec.substr(colon + 1));
+    } catch (...) { std::cerr << "\nError: The --generate argument must be bits[:seed].\n"; return 1; }
+    if (bits < 4) { std::cerr << "\nError: --generate needs at least 4 bits.\n"; return 1; }
+    for (int i = 3; i < argc; ++i) {
+        if (std::string(argv[i]) == "-o" && i + 1 < argc) output_directory = argv[++i];
+        else { std::cerr << "\nError: Unknown option " << argv[i] << " for --generate.\n"; return 1; }
+    }
+    big_int p, q;
+    randomSemiprime(bits, seed, p, q);
+    std::string dimacs = FactoringCnf::dimacs(p * q, static_cast<int>(mpz_sizeinbase(p.get_mpz_t(), 2)),
+                                              static_cast<int>(mpz_sizeinbase(q.get_mpz_t(), 2)));
+    std::string path = output_directory + "/rsaFACT-" + std::to_string(bits) + "bit-" + std::to_string(seed) + ".dimacs";
+    exportResultsToFile(path, dimacs);
+    std::cout << "   Generated: " << path << std::endl;
+    std::cout << "Input Number: " << p * q << " (" << p << " * " << q << ")" << std::endl;
+    return 0;
+}
+
+#ifndef NDP_NO_MAIN   // defined by NDP-4_5_7_bench.cpp, which brings its own main
 int main(int argc, char* argv[]) {
     PROFILE_SCOPE("main");
     int max_queues = -1;
@@ -921,9 +1868,11 @@ int main(int argc, char* argv[]) {
     int iterations = 0;
     std::string script_name = std::filesystem::path(argv[0]).stem().string();
     if (argc < 2) {
-        std::cerr << "\nUsage: " << argv[0] << " <filename> [-r reserve_cores] [-d depth | -t max_tasks] [-q max_queues] [-o output_directory]" << std::endl;
+        std::cerr << "\nUsage: " << argv[0] << " <filename> [-r reserve_cores] [-d depth | -t max_tasks] [-q max_queues] [-o output_directory] [--scc interval] [--gates] [--gauss interval] [--symmetry] [--lowbits k] [--branch clause|lsb|msb|vsids|order_file] [--restart luby|geometric|lbd[:conflicts]] [--polarity false|true|saved|random[:seed]|factor] [--diversify] [--portfolio cubes|formula] [--cubes] [--stream depth] [--checkpoint file[:seconds]] [--resume file] [--quiet] [--progress ms] [--progress-log file] [--task-times file] [--trace file] [--perf] [--pin compact|scatter] [--hugepages off|thp|hugetlb]\n       " << argv[0] << " --generate bits[:seed] [-o output_directory]" << std::endl;
         return 1;
     }
+    if (std::string(argv[1]) == "--generate")
+        return generateFactoringCnf(argc, argv);
     std::string filename = argv[1];
     std::string fileContent = readFileToString(filename);
     if (fileContent.empty())
@@ -951,7 +1900,20 @@ int main(int argc, char* argv[]) {
     bool override_max_tasks = false;
     std::string output_directory = getWorkingDirectory();
     std::string cli_flag = "auto";
-    if (argc >= 4) {
+    SearchConfig search_config;
+    bool symmetry_breaking = false;
+    int low_bits = 0;
+    std::string branch_option = "clause";
+    std::string portfolio_mode;
+    bool cube_tasks = false;
+    int stream_depth = 0;
+    ProgressConfig progress_config;
+    bool perf_counters = false;
+    numa::Policy pin_policy = numa::Policy::None;
+    hugepages::Mode huge_pages = hugepages::Mode::Off;
+    std::string checkpoint_path, resume_path;
+    int checkpoint_interval = 60;
+    if (argc >= 3) {
         for (int i = 1; i < argc; ++i) {
             std::string option = argv[i];
             if (option == "-q") {
@@ -976,6 +1938,124 @@ int main(int argc, char* argv[]) {
                 }
             } else if (option == "-o") {
                 if (++i < argc) { output_directory = argv[i]; }
+            } else if (option == "--hugepages") {
+                if (++i < argc) {
+                    std::string mode = argv[i];
+                    if (mode == "off") huge_pages = hugepages::Mode::Off;
+                    else if (mode == "thp") huge_pages = hugepages::Mode::Thp;
+                    else if (mode == "hugetlb") huge_pages = hugepages::Mode::Hugetlb;
+                    else { std::cerr << "\nError: Unknown --hugepages mode " << mode << " (off, thp, hugetlb).\n"; return 1; }
+                } else { std::cerr << "\nError: Missing argument for --hugepages option.\n"; return 1; }
+            } else if (option == "--pin") {
+                if (++i < argc) {
+                    std::string policy = argv[i];
+                    if (policy == "compact") pin_policy = numa::Policy::Compact;
+                    else if (policy == "scatter") pin_policy = numa::Policy::Scatter;
+                    else { std::cerr << "\nError: Unknown --pin policy " << policy << " (compact, scatter).\n"; return 1; }
+                } else { std::cerr << "\nError: Missing argument for --pin option.\n"; return 1; }
+            } else if (option == "--perf") {
+                perf_counters = true;
+            } else if (option == "--trace") {
+                if (++i < argc) { trace.configure(argv[i]); }
+                else { std::cerr << "\nError: Missing argument for --trace option.\n"; return 1; }
+            } else if (option == "--task-times") {
+                if (++i < argc) { task_times.configure(argv[i]); }
+                else { std::cerr << "\nError: Missing argument for --task-times option.\n"; return 1; }
+            } else if (option == "--quiet") {
+                progress_config.quiet = true;
+            } else if (option == "--progress") {
+                if (++i < argc) {
+                    try { progress_config.interval_ms = std::max(10, std::stoi(argv[i])); }
+                    catch (...) { std::cerr << "\nError: The --progress interval must be an integer.\n"; return 1; }
+                } else { std::cerr << "\nError: Missing argument for --progress option.\n"; return 1; }
+            } else if (option == "--progress-log") {
+                if (++i < argc) { progress_config.log_path = argv[i]; }
+                else { std::cerr << "\nError: Missing argument for --progress-log option.\n"; return 1; }
+            } else if (option == "--stream") {
+                if (++i < argc) {
+                    try { stream_depth = std::stoi(argv[i]); }
+                    catch (...) { std::cerr << "\nError: The --stream depth must be an integer.\n"; return 1; }
+                } else { std::cerr << "\nError: Missing argument for --stream option.\n"; return 1; }
+            } else if (option == "--cubes") {
+                cube_tasks = true;
+            } else if (option == "--checkpoint") {
+                if (++i < argc) {
+                    checkpoint_path = argv[i];
+                    std::size_t colon = checkpoint_path.rfind(':');
+                    if (colon != std::string::npos && colon + 1 < checkpoint_path.size() &&
+                        checkpoint_path.find_first_not_of("0123456789", colon + 1) == std::string::npos) {
+                        try { checkpoint_interval = std::max(1, std::stoi(checkpoint_path.substr(colon + 1))); }
+                        catch (...) { std::cerr << "\nError: The --checkpoint interval is out of range.\n"; return 1; }
+                        checkpoint_path.resize(colon);
+                    }
+                } else { std::cerr << "\nError: Missing argument for --checkpoint option.\n"; return 1; }
+            } else if (option == "--resume") {
+                if (++i < argc) { resume_path = argv[i]; }
+                else { std::cerr << "\nError: Missing argument for --resume option.\n"; return 1; }
+            } else if (option == "--portfolio") {
+                if (++i < argc) { portfolio_mode = argv[i]; }
+                else { std::cerr << "\nError: Missing argument for --portfolio option.\n"; return 1; }
+                if (portfolio_mode != "cubes" && portfolio_mode != "formula") {
+                    std::cerr << "\nError: Unknown --portfolio mode " << portfolio_mode << " (cubes, formula).\n"; return 1;
+                }
+            } else if (option == "--polarity") {
+                if (++i < argc) {
+                    std::string policy = argv[i];
+                    std::size_t colon = policy.find(':');
+                    if (colon != std::string::npos) {
+                        try { search_config.polarity.seed = std::stoull(policy.substr(colon + 1)); }
+                        catch (...) { std::cerr << "\nError: The --polarity seed must be an integer.\n"; return 1; }
+                        policy.resize(colon);
+                    }
+                    if (policy == "false") search_config.polarity.kind = PolarityConfig::Kind::False;
+                    else if (policy == "true") search_config.polarity.kind = PolarityConfig::Kind::True;
+                    else if (policy == "saved") search_config.polarity.kind = PolarityConfig::Kind::Saved;
+                    else if (policy == "random") search_config.polarity.kind = PolarityConfig::Kind::Random;
+                    else if (policy == "factor") search_config.polarity.kind = PolarityConfig::Kind::FactorLikely;
+                    else { std::cerr << "\nError: Unknown --polarity " << policy << " (false, true, saved, random, factor).\n"; return 1; }
+                } else { std::cerr << "\nError: Missing argument for --polarity option.\n"; return 1; }
+            } else if (option == "--diversify") {
+                search_config.polarity.diversify = true;
+            } else if (option == "--restart") {
+                if (++i < argc) {
+                    std::string policy = argv[i];
+                    std::size_t colon = policy.find(':');
+                    if (colon != std::string::npos) {
+                        long long base = 0;
+                        try { base = std::stoll(policy.substr(colon + 1)); }
+                        catch (...) { std::cerr << "\nError: The --restart conflict count must be an integer.\n"; return 1; }
+                        if (base < 1) { std::cerr << "\nError: The --restart conflict count must be 1 or greater.\n"; return 1; }
+                        search_config.restarts.base = static_cast<std::uint64_t>(base);
+                        policy.resize(colon);
+                    }
+                    if (policy == "luby") search_config.restarts.kind = RestartConfig::Kind::Luby;
+                    else if (policy == "geometric") search_config.restarts.kind = RestartConfig::Kind::Geometric;
+                    else if (policy == "lbd") search_config.restarts.kind = RestartConfig::Kind::Lbd;
+                    else { std::cerr << "\nError: Unknown --restart policy " << policy << " (luby, geometric, lbd).\n"; return 1; }
+                } else { std::cerr << "\nError: Missing argument for --restart option.\n"; return 1; }
+            } else if (option == "--branch") {
+                if (++i < argc) { branch_option = argv[i]; }
+                else { std::cerr << "\nError: Missing argument for --branch option.\n"; return 1; }
+            } else if (option == "--lowbits") {
+                if (++i < argc) {
+                    try { low_bits = std::stoi(argv[i]); }
+                    catch (...) { std::cerr << "\nError: The --lowbits argument must be an integer.\n"; return 1; }
+                    if (low_bits < 0) { std::cerr << "\nError: The --lowbits argument must not be negative.\n"; return 1; }
+                } else { std::cerr << "\nError: Missing argument for --lowbits option.\n"; return 1; }
+            } else if (option == "--symmetry") {
+                symmetry_breaking = true;
+            } else if (option == "--gates") {
+                search_config.gate_propagation = true;
+            } else if (option == "--gauss") {
+                if (++i < argc) {
+                    try { search_config.gauss_interval = std::stoi(argv[i]); }
+                    catch (...) { std::cerr << "\nError: The --gauss interval must be an integer.\n"; return 1; }
+                } else { std::cerr << "\nError: Missing argument for --gauss option.\n"; return 1; }
+            } else if (option == "--scc") {
+                if (++i < argc) {
+                    try { search_config.scc_interval = std::stoi(argv[i]); }
+                    catch (...) { std::cerr << "\nError: The --scc interval must be an integer.\n"; return 1; }
+                } else { std::cerr << "\nError: Missing argument for --scc option.\n"; return 1; }
             }
         }
     }
@@ -993,29 +2073,231 @@ int main(int argc, char* argv[]) {
     if (max_tasks > 0 && !override_max_tasks) std::cout << "  BFS #Tasks: " << max_tasks << std::endl;
     if (depth > 0 && override_max_tasks) std::cout << "       Depth: " << depth << std::endl;
     else if (max_queues > 0) std::cout << "  Queue size: " << max_queues << std::endl;
+    if (search_config.scc_interval > 0) std::cout << "   SCC every: " << search_config.scc_interval << " nodes" << std::endl;
     std::cout << std::endl;
     
-    ClauseSet clauses = parseDimacsString(fileContent);
+    std::vector<int> v1, v2;
+    ExtractInputsFromDimacs(fileContent, v1, v2);
+    
+    ClauseStore store = parseDimacsStore(fileContent);
+    if (symmetry_breaking) {
+        std::size_t added = addFactorSymmetryBreaking(store, num_vars, v1, v2);
+        std::cout << "    Symmetry: " << (v1.size() > v2.size() ? "FACT 2 <= FACT 1" : "FACT 1 <= FACT 2")
+                  << ", FACT != 1 (" << added << " clauses)" << std::endl << std::endl;
+    }
+    if (branch_option == "lsb" || branch_option == "msb")
+        search_config.branching = inputBitsFirst(v1, v2, branch_option == "lsb");
+    else if (branch_option == "vsids") {
+        search_config.branching.kind = BranchingConfig::Kind::Vsids;
+        search_config.branching.name = "EVSIDS activity";
+    } else if (branch_option != "clause") {
+        search_config.branching = staticOrderFromFile(branch_option);
+        if (!search_config.branching.order || search_config.branching.order->empty()) {
+            std::cerr << "\nError: Could not read a branching order from " << branch_option << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "   Branching: " << search_config.branching.name << std::endl << std::endl;
+    search_config.polarity.likely = factorLikelyPolarity(v1, v2, input_number % 2 != 0);
+    std::cout << "    Polarity: " << polarityName(search_config.polarity)
+              << (search_config.polarity.diversify ? ", rotated per DFS thread" : "") << std::endl << std::endl;
+    if (search_config.restarts.kind != RestartConfig::Kind::None)
+        std::cout << "    Restarts: " << restartName(search_config.restarts) << std::endl << std::endl;
+    if (perf_counters) {
+        std::string perf_error;
+        if (perf::Counters::instance().enable(perf_error))
+            std::cout << "        Perf: cycles, instructions, L1D/LLC/branch misses per thread (BFS, DFS tasks, resolution)" << std::endl << std::endl;
+        else
+            std::cout << "        Perf: not available (" << perf_error << "), continuing without counters" << std::endl << std::endl;
+    }
+    if (huge_pages != hugepages::Mode::Off) {
+        std::string huge_error, huge_note;
+        if (hugepages::Regions::instance().configure(huge_pages, huge_error, huge_note))
+            std::cout << "  Huge pages: " << hugepages::modeName(huge_pages) << " for clause sets of 2 MB and more"
+                      << (huge_note.empty() ? "" : " (" + huge_note + ")") << std::endl << std::endl;
+        else
+            std::cout << "  Huge pages: not available (" << huge_error << "), clause sets on 4 KB pages" << std::endl << std::endl;
+    }
+    
+    std::vector<std::vector<int>> seed_cubes;
+    if (low_bits > 0) {
+        std::vector<int> fixed;
+        low_bits = lowBitCubes(input_number, v1, v2, low_bits, fixed, seed_cubes);   // the k actually used
+        for (int lit : fixed)
+            store.addClause(&lit, &lit + 1);
+        std::cout << "    Low bits: " << low_bits << " (" << fixed.size() << " fixed, "
+                  << seed_cubes.size() << " BFS cubes)" << std::endl << std::endl;
+    }
+    int engine_vars = num_vars;
+    ClauseSet clauses = lowerToClauseSet(store, engine_vars);
     if (clauses.empty()) throw std::runtime_error("\nError parsing DIMACS string.\n");
+    if (store.width_histogram[2] > 0 || !store.fitsClause3()) {
+        std::cout << "    Binaries: " << store.width_histogram[2] << " (" << buildImplicationGraph(store).numEdges() << " implications)" << std::endl;
+        std::cout << "   Wide (>3): " << store.width_histogram[4] << " (" << (engine_vars - num_vars) << " aux VARs)" << std::endl;
+        std::cout << std::endl;
+    }
+    if (search_config.gate_propagation || search_config.gauss_interval > 0) {
+        CircuitPropagator circuit(clauses);
+        std::cout << "   XOR gates: " << circuit.numXors() << std::endl;
+        std::cout << "   AND gates: " << circuit.numAnd() << std::endl;
+        std::cout << "   MAJ gates: " << circuit.numMaj() << std::endl;
+        if (search_config.gauss_interval > 0) std::cout << " Gauss every: " << search_config.gauss_interval << " nodes" << std::endl;
+        std::cout << std::endl;
+    }
     
     omp_set_num_threads(usable_cores);
 
+    if (pin_policy != numa::Policy::None) {
+        std::string pin_error;
+        if (!placement.configure(pin_policy, usable_cores, reserve_cores, pin_error))
+            std::cout << "     Pinning: not available (" << pin_error << "), workers unpinned" << std::endl << std::endl;
+    }
+    std::atomic<int> unpinned{0};
     #pragma omp parallel
-    { }
+    {
+        if (placement.enabled() && !placement.pinCurrentThread(omp_get_thread_num()))
+            unpinned.fetch_add(1);
+    }
+    if (placement.enabled()) {
+        std::cout << "     Pinning: " << placement.describe();
+        if (unpinned.load() > 0)
+            std::cout << " (" << unpinned.load() << " workers could not be pinned)";
+        std::cout << std::endl << std::endl;
+    }
     dfs_running = true;
     
-    std::vector<int> v1, v2;
-    ExtractInputsFromDimacs(fileContent, v1, v2);
+    std::vector<SearchConfig> portfolio;
+    if (!portfolio_mode.empty()) {
+        portfolio = makePortfolio(search_config, usable_cores, v1, v2);
+        std::cout << "   Portfolio: " << portfolio.size() << " configurations on "
+                  << (portfolio_mode == "formula" ? "the whole formula" : "every BFS cube") << std::endl;
+        for (std::size_t t = 0; t < portfolio.size() && t < 8; ++t)
+            std::cout << "              " << t << ": " << describeSearchConfig(portfolio[t]) << std::endl;
+        if (portfolio.size() > 8)
+            std::cout << "              ..." << std::endl;
+        std::cout << std::endl;
+    }
+    
+    if (stream_depth > 0 && (!portfolio_mode.empty() || !checkpoint_path.empty() || !resume_path.empty())) {
+        std::cerr << "\nError: --stream cannot be combined with --portfolio, --checkpoint or --resume.\n";
+        return 1;
+    }
+    progress.configure(progress_config);
+    // Start the reporter thread now (it is idle until the BFS), off worker 0's pinned CPU.
+    placement.spawnHelper([]() { progress.phase(ProgressReporter::Phase::Idle); });
+    // A checkpoint's cubes only fit the clause set they were built on.
+    std::ostringstream checkpoint_options;
+    checkpoint_options << "vars=" << engine_vars << " clauses=" << clauses.size()
+                       << " symmetry=" << symmetry_breaking << " lowbits=" << low_bits;
+    if (!resume_path.empty() && checkpoint_path.empty())
+        checkpoint_path = resume_path;
     
     auto bfs_start = std::chrono::high_resolution_clock::now();
-    auto [results, task_count] = Satisfy_iterative_BFS(clauses, depth, max_tasks, override_max_tasks, iterations, max_queues);
+    TaskQueue results;
+    int task_count = 1;
+    if (!resume_path.empty()) {
+        Checkpoint resumed;
+        if (!readCheckpoint(resume_path, resumed)) {
+            std::cerr << "\nError: Could not read checkpoint " << resume_path << std::endl;
+            return 1;
+        }
+        if (resumed.input_number != mpz_to_string(input_number) || resumed.options != checkpoint_options.str()) {
+            std::cerr << "\nError: Checkpoint " << resume_path << " was written for " << resumed.input_number
+                      << " (" << resumed.options << "), not " << input_number << " (" << checkpoint_options.str() << ")" << std::endl;
+            return 1;
+        }
+        std::vector<char> finished(resumed.cubes.size(), 0);
+        for (std::uint32_t k : resumed.finished)
+            if (k < finished.size())
+                finished[k] = 1;
+        for (std::size_t k = 0; k < resumed.cubes.size(); ++k) {
+            if (finished[k])
+                continue;
+            if (cube_tasks) {
+                results.emplace(ClauseSet(), resumed.cubes[k]);
+                continue;
+            }
+            ClauseSetBranch task = assignLiterals(clauses, resumed.cubes[k]);
+            if (!task.conflict)
+                results.emplace(std::move(task.cs), resumed.cubes[k]);
+        }
+        task_count = static_cast<int>(results.size());
+        std::cout << "      Resume: " << results.size() << " of " << resumed.cubes.size() << " tasks left ("
+                  << resumed.finished.size() << " finished)" << std::endl << std::endl;
+    } else if (stream_depth > 0)
+        task_count = 0;   // the tasks are produced while the DFS runs
+    else if (portfolio_mode == "formula")
+        results.emplace(cube_tasks ? ClauseSet() : std::move(clauses), std::vector<int>());
+    else {
+        progress.phase(ProgressReporter::Phase::Bfs);
+        Trace::Event bfs_event{"BFS", "bfs", 0, Trace::Clock::now(), {}};
+        {
+            perf::Scope bfs_perf(perf::Bfs);
+            std::tie(results, task_count) = Satisfy_iterative_BFS(clauses, depth, max_tasks, override_max_tasks, iterations, max_queues,
+                                                                  seed_cubes, search_config, cube_tasks);
+        }
+        bfs_event.end = Trace::Clock::now();
+        bfs_event.task = task_count;
+        trace.record(bfs_event);
+        progress.phase(ProgressReporter::Phase::Idle);
+    }
+    if (cube_tasks && stream_depth == 0)
+        std::cout << "  Task store: cubes (" << results.size() << " tasks, clause sets derived per task)" << std::endl;
     
-    auto dfs_start = std::chrono::high_resolution_clock::now();
-    std::vector<std::vector<int>> final_choices_parallel = process_queue(
-        results, true, input_number, num_bits, num_vars, num_clauses,
-        v1, v2, bfs_start, dfs_start, usable_cores, task_count,
-        script_name, filename, cli_flag, reserve_cores, output_directory,
-        override_max_tasks, iterations, total_cores);
+    std::unique_ptr<CheckpointWriter> checkpoint;
+    if (!checkpoint_path.empty()) {
+        Checkpoint frontier;
+        frontier.input_number = mpz_to_string(input_number);
+        frontier.options = checkpoint_options.str();
+        for (std::size_t k = results.size(); k > 0; --k) {   // rotate once, no clause set copies
+            frontier.cubes.push_back(results.front().cube);
+            results.push(std::move(results.front()));
+            results.pop();
+        }
+        checkpoint = std::make_unique<CheckpointWriter>(checkpoint_path, checkpoint_interval, std::move(frontier));
+        if (!checkpoint->write()) {
+            std::cerr << "\nError: Could not write checkpoint " << checkpoint_path << std::endl;
+            return 1;
+        }
+        std::cout << "  Checkpoint: " << checkpoint_path << " every " << checkpoint_interval << " seconds" << std::endl;
+    }
     
-    return 0;
-}
\ No newline at end of file
+    // Streaming: one extra thread expands the formula and feeds the DFS threads.
+    std::unique_ptr<BoundedTaskQueue> stream;
+    std::thread producer;
+    if (stream_depth > 0) {
+        std::size_t capacity = 4 * static_cast<std::size_t>(usable_cores);
+        stream = std::make_unique<BoundedTaskQueue>(capacity);
+        std::cout << "      Stream: tasks at " << stream_depth << " two-way splits, queue capacity " << capacity
+                  << (cube_tasks ? ", stored as cubes" : "") << std::endl;
+        trace.nameThread(kTraceProducerThread, "BFS producer");
+        auto produce = [&]() {
+            Trace::Event event{"stream BFS", "bfs", kTraceProducerThread, Trace::Clock::now(), {}};
+            {
+                perf::Scope bfs_perf(perf::Bfs);
+                streamTasks(clauses, stream_depth, seed_cubes, search_config, cube_tasks, *stream);
+            }
+            event.end = Trace::Clock::now();
+            event.task = static_cast<long long>(stream->pushed());
+            trace.record(event);
+        };
+        placement.spawnHelper([&]() { producer = std::thread(produce); });
+    }
+    
+    auto dfs_start = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> bfs_duration = dfs_start - bfs_start;
+    std::cout << "\n    BFS time: " << bfs_duration.count() << " seconds  -  DFS parallel initiated..\n" << std::endl;
+    DfsResult result = process_queue(std::move(results), usable_cores, task_count, search_config, portfolio,
+                                     checkpoint.get(), cube_tasks ? &clauses : nullptr, stream.get());
+    // Stop the producer before the report: it records its trace span only when it returns.
+    if (producer.joinable()) {
+        stream->cancel();
+        producer.join();
+    }
+    reportResult(result, input_number, num_bits, num_vars, num_clauses, v1, v2, bfs_start, dfs_start, usable_cores,
+                 script_name, filename, cli_flag, reserve_cores, output_directory, iterations, total_cores);
+    std::cout << "\n" << std::endl;
+    dumpProfilingResults();
+    std::terminate();
+}
+#endif // NDP_NO_MAIN
@@ -0,0 +1,230 @@
+// NDP-4_5_7_bench.cpp
+//
+// Kernel Micro-Benchmarks for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// Google Benchmark suite for the hot kernels of the solver, each in isolation:
+// ResolutionStep, ResolutionStepWithConflict, choice, parseDimacsString and
+// ClauseSetPool::obtain/release. Catches kernel regressions in seconds instead of
+// multi-hour factoring runs.
+//
+// Inputs:
+//   synthetic  random clause sets in the engine's mix of 1-, 2- and 3-literal clauses
+//              (as in a Tseitin-encoded multiplier), 256 to 65536 clauses, fixed seed
+//   multiplier the factoring CNF of CnfGenerator.hpp for a 16-, 32-, 48- and 64-bit
+//              semiprime (seed 1); registered as <kernel>_Multiplier/<bits>
+//   real       every --dimacs=<file> given on the command line, e.g. a Purdom-Sabry
+//              rsaFACT instance; registered as <kernel>/<file name>
+//
+// To compile (Google Benchmark: sudo apt install libbenchmark-dev):
+//
+// 	g++ -fopenmp -std=c++17 -O3 -march=native -o NDP-4_5_7_bench NDP-4_5_7_bench.cpp -lgmpxx -lgmp -lbenchmark -lpthread
+//
+// Run:
+//
+// 	./NDP-4_5_7_bench [--dimacs=inputs/RSA/rsaFACT-24bit.dimacs ...] [--benchmark_filter=Resolution]
+//
+#define NDP_NO_MAIN
+#include "NDP-4_5_7.cpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+namespace {
+
+// DIMACS text of a random formula over `vars` variables with `clauses` clauses:
+// 10% 1-literal, 40% 2-literal and 50% 3-literal clauses, no variable twice in a clause.
+std::string syntheticDimacs(int vars, int clauses, std::uint64_t seed = 4711) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> var(1, vars), width(0, 9), sign(0, 1);
+    std::ostringstream out;
+    out << "p cnf " << vars << " " << clauses << "\n";
+    for (int c = 0; c < clauses; ++c) {
+        int w = width(rng);
+        int k = w == 0 ? 1 : w < 5 ? 2 : 3;
+        int lits[3] = {0, 0, 0};
+        for (int j = 0; j < k; ++j) {
+            int v;
+            do v = var(rng); while (std::find(lits, lits + j, v) != lits + j || std::find(lits, lits + j, -v) != lits + j);
+            lits[j] = sign(rng) ? v : -v;
+            out << lits[j] << " ";
+        }
+        out << "0\n";
+    }
+    return out.str();
+}
+
+struct Input {
+    std::string dimacs;
+    ClauseSet cs;
+    ClauseSet no_units;   // cs without 1-literal clauses: choice() scans all of it, as after propagation
+    int split_var;        // the variable choice() picks, so every kernel splits on a real variable
+};
+
+Input makeInput(std::string dimacs) {
+    Input input;
+    input.dimacs = std::move(dimacs);
+    input.cs = parseDimacsString(input.dimacs);
+    input.split_var = choice(input.cs);
+    for (const Clause3 &cl : input.cs)
+        if (cl.l[0] != 0 || cl.l[1] != 0)
+            input.no_units.push_back(cl);
+    return input;
+}
+
+const Input &synthetic(int clauses) {
+    static std::map<int, Input> inputs;
+    auto it = inputs.find(clauses);
+    if (it == inputs.end())
+        it = inputs.emplace(clauses, makeInput(syntheticDimacs(std::max(8, clauses / 4), clauses))).first;
+    return it->second;
+}
+
+const Input &multiplier(int bits) {
+    static std::map<int, Input> inputs;
+    auto it = inputs.find(bits);
+    if (it == inputs.end()) {
+        mpz_class p, q;
+        randomSemiprime(bits, 1, p, q);
+        std::string dimacs = FactoringCnf::dimacs(p * q, static_cast<int>(mpz_sizeinbase(p.get_mpz_t(), 2)),
+                                                  static_cast<int>(mpz_sizeinbase(q.get_mpz_t(), 2)));
+        it = inputs.emplace(bits, makeInput(std::move(dimacs))).first;
+    }
+    return it->second;
+}
+
+void setCounters(benchmark::State &state, const Input &input) {
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(input.cs.size()));
+    state.counters["clauses"] = static_cast<double>(input.cs.size());
+}
+
+void runResolutionStep(benchmark::State &state, const Input &input) {
+    for (auto _ : state) {
+        auto branches = ResolutionStep(input.cs, input.split_var);
+        benchmark::DoNotOptimize(branches);
+    }
+    setCounters(state, input);
+}
+
+void runResolutionStepWithConflict(benchmark::State &state, const Input &input) {
+    for (auto _ : state) {
+        auto branches = ResolutionStepWithConflict(input.cs, input.split_var);
+        benchmark::DoNotOptimize(branches);
+    }
+    setCounters(state, input);
+}
+
+void runChoice(benchmark::State &state, const Input &input) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(choice(input.no_units));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(input.no_units.size()));
+    state.counters["clauses"] = static_cast<double>(input.no_units.size());
+}
+
+void runParseDimacsString(benchmark::State &state, const Input &input) {
+    for (auto _ : state) {
+        ClauseSet cs = parseDimacsString(input.dimacs);
+        benchmark::DoNotOptimize(cs.data());
+    }
+    setCounters(state, input);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(input.dimacs.size()));
+}
+
+// Obtain a set, fill it like a resolution child, release it: the DFS pattern per node.
+void runPoolObtainRelease(benchmark::State &state, const Input &input) {
+    ClauseSetPool pool;
+    for (auto _ : state) {
+        ClauseSet *cs = pool.obtain(input.cs.size());
+        cs->assign(input.cs.begin(), input.cs.end());
+        benchmark::DoNotOptimize(cs->data());
+        pool.release(cs);
+    }
+    setCounters(state, input);
+}
+
+#define NDP_KERNEL_BENCHMARK(kernel)                                           \
+    void BM_##kernel(benchmark::State &state) {                                \
+        run##kernel(state, synthetic(static_cast<int>(state.range(0))));       \
+    }                                                                          \
+    BENCHMARK(BM_##kernel)->RangeMultiplier(4)->Range(256, 65536);             \
+    void BM_##kernel##_Multiplier(benchmark::State &state) {                   \
+        run##kernel(state, multiplier(static_cast<int>(state.range(0))));      \
+    }                                                                          \
+    BENCHMARK(BM_##kernel##_Multiplier)->DenseRange(16, 64, 16)
+
+NDP_KERNEL_BENCHMARK(ResolutionStep);
+NDP_KERNEL_BENCHMARK(ResolutionStepWithConflict);
+NDP_KERNEL_BENCHMARK(Choice);
+NDP_KERNEL_BENCHMARK(ParseDimacsString);
+NDP_KERNEL_BENCHMARK(PoolObtainRelease);
+
+// Register every kernel once more for each --dimacs=<file>; returns false on an unreadable file.
+bool registerDimacsBenchmarks(int &argc, char *argv[]) {
+    static std::vector<std::unique_ptr<Input>> inputs;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--dimacs=", 0) != 0) {
+            argv[kept++] = argv[i];
+            continue;
+        }
+        std::string path = arg.substr(9);
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "\nError: Could not open " << path << std::endl;
+            return false;
+        }
+        std::stringstream data;
+        data << file.rdbuf();
+        inputs.push_back(std::make_unique<Input>(makeInput(data.str())));
+        const Input *input = inputs.back().get();
+        std::string name = std::filesystem::path(path).filename().string();
+        benchmark::RegisterBenchmark(("BM_ResolutionStep/" + name).c_str(),
+                                     [input](benchmark::State &s) { runResolutionStep(s, *input); });
+        benchmark::RegisterBenchmark(("BM_ResolutionStepWithConflict/" + name).c_str(),
+                                     [input](benchmark::State &s) { runResolutionStepWithConflict(s, *input); });
+        benchmark::RegisterBenchmark(("BM_Choice/" + name).c_str(),
+                                     [input](benchmark::State &s) { runChoice(s, *input); });
+        benchmark::RegisterBenchmark(("BM_ParseDimacsString/" + name).c_str(),
+                                     [input](benchmark::State &s) { runParseDimacsString(s, *input); });
+        benchmark::RegisterBenchmark(("BM_PoolObtainRelease/" + name).c_str(),
+                                     [input](benchmark::State &s) { runPoolObtainRelease(s, *input); });
+    }
+    argc = kept;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (!registerDimacsBenchmarks(argc, argv))
+        return 1;
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,308 @@
+// NDP-4_5_7_scaling.cpp
+//
+// End-to-End Scaling Benchmark for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// Runs the whole BFS + DFS pipeline in-process over a matrix of instances, split
+// settings (-d / -t / -q, as in NDP-4_5_7) and thread counts, each point several times,
+// and writes two CSV files:
+//
+//   <prefix>-runs.csv     one row per run: BFS, DFS and wall time, BFS depth and tasks,
+//                         DFS nodes and nodes/s, result (solution, prime, FALSE)
+//   <prefix>-scaling.csv  one row per instance, split and thread count: median times and
+//                         nodes/s over the repetitions, speedup and parallel efficiency
+//                         against the smallest thread count of the sweep
+//
+// The thread counts are interleaved within every repetition, so a drifting machine
+// (thermal throttling, other jobs) hits all of them alike. The DFS is process_queue of
+// NDP-4_5_7 (without the report its main prints); the first solution cancels the other threads.
+//
+// To compile:
+//
+// 	g++ -fopenmp -std=c++17 -Ofast -march=native -o NDP-4_5_7_scaling NDP-4_5_7_scaling.cpp -lgmpxx -lgmp
+//
+// Run:
+//
+// 	./NDP-4_5_7_scaling [dimacs_file ...] [--bits b1,b2,... [--seed n]] [--threads n1,n2,...]
+// 	                    [-d d1,d2,...] [-t t1,t2,...] [-q q1,q2,...] [--reps n] [-o prefix]
+//
+//     dimacs_file: Purdom-Sabry style DIMACS files.
+//     --bits: Also generate the factoring CNF of a random semiprime of every bit width (see
+//             --generate of NDP-4_5_7), from --seed (default 1).
+//     --threads: Thread counts (default 1, 2, 4, ... up to all cores).
+//     -d, -t, -q: Split settings, one sweep point per value; the default (none given) is
+//                 max_tasks = num_clauses - num_vars.
+//     --reps: Repetitions per point (default 3).
+//     -o: Prefix of the two CSV files (default NDP-4_5_7_scaling).
+//
+// 	Example: ./NDP-4_5_7_scaling --bits 20,24,28 --threads 1,2,4,8 -d 500,2000 --reps 5
+//
+#define NDP_NO_MAIN
+#include "NDP-4_5_7.cpp"
+
+namespace {
+
+struct Instance {
+    std::string name;
+    big_int input_number;
+    int num_bits = 0;
+    int num_vars = 0;
+    int num_clauses = 0;
+    std::vector<int> v1, v2;
+    ClauseSet clauses;
+};
+
+// Split settings of one sweep point, with the same meaning as -d / -t / -q of NDP-4_5_7.
+struct Split {
+    char kind;   // 'a' (auto), 'd', 't' or 'q'
+    int value;
+
+    std::string name() const { return kind == 'a' ? std::string("auto") : kind + std::to_string(value); }
+};
+
+struct Run {
+    double bfs_seconds, dfs_seconds;
+    int tasks, depth;
+    std::uint64_t nodes;
+    const char *result;
+
+    double wall() const { return bfs_seconds + dfs_seconds; }
+    double nodesPerSecond() const { return dfs_seconds > 0 ? nodes / dfs_seconds : 0.0; }
+};
+
+// Header, input vectors and clause set as main() reads them; false if the header lacks them.
+// num_bits is the bit length of the product.
+bool loadInstance(const std::string &name, const std::string &dimacs, Instance &instance) {
+    std::smatch match;
+    std::regex regex_product(R"(Circuit for product = ([0-9]+) \[)");
+    std::regex regex_problem(R"(p cnf ([0-9]+) ([0-9]+))");
+    if (!std::regex_search(dimacs, match, regex_product))
+        return false;
+    instance.input_number = mpz_class(match[1].str());
+    instance.num_bits = static_cast<int>(mpz_sizeinbase(instance.input_number.get_mpz_t(), 2));
+    if (!std::regex_search(dimacs, match, regex_problem))
+        return false;
+    instance.num_vars = std::stoi(match[1].str());
+    instance.num_clauses = std::stoi(match[2].str());
+    instance.name = name;
+    ExtractInputsFromDimacs(dimacs, instance.v1, instance.v2);
+    int engine_vars = instance.num_vars;
+    instance.clauses = lowerToClauseSet(parseDimacsStore(dimacs), engine_vars);
+    return !instance.clauses.empty();
+}
+
+bool parseList(const std::string &text, std::vector<int> &values) {
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        try { values.push_back(std::stoi(item)); }
+        catch (...) { return false; }
+    }
+    return !values.empty();
+}
+
+Run runOnce(const Instance &instance, const Split &split, int threads) {
+    int max_tasks = 0, depth = 0, max_queues = -1;
+    bool override_max_tasks = false;
+    if (split.kind == 'd') { depth = split.value; override_max_tasks = true; }
+    else if (split.kind == 't') { max_tasks = split.value; depth = max_tasks; }
+    else if (split.kind == 'q') max_queues = split.value;
+    if (max_tasks == 0 && !override_max_tasks) { max_tasks = calculate_max_tasks(instance.num_vars, instance.num_clauses); depth = max_tasks; }
+
+    omp_set_num_threads(threads);
+    std::uint64_t nodes_before = progress.totals().nodes;
+    auto bfs_start = std::chrono::high_resolution_clock::now();
+    TaskQueue queue;
+    int task_count = 0, iterations = 0;
+    std::tie(queue, task_count) = Satisfy_iterative_BFS(instance.clauses, depth, max_tasks, override_max_tasks, iterations, max_queues);
+    auto dfs_start = std::chrono::high_resolution_clock::now();
+    DfsResult result = process_queue(std::move(queue), threads, task_count);
+
+    Run run;
+    run.bfs_seconds = std::chrono::duration<double>(dfs_start - bfs_start).count();
+    run.dfs_seconds = std::chrono::duration<double>(result.end - dfs_start).count();
+    run.tasks = task_count;
+    run.depth = iterations;
+    run.nodes = progress.totals().nodes - nodes_before;
+    run.result = "prime";
+    if (!result.final_choices.empty()) {
+        auto [d1, d2] = convert(result.final_choices, instance.v1, instance.v2);
+        run.result = d1 * d2 == instance.input_number ? "solution" : "FALSE";
+    }
+    return run;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    std::size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> files;
+    std::vector<int> bits, threads, depths, task_limits, queue_limits;
+    unsigned long seed = 1;
+    int reps = 3;
+    std::string prefix = "NDP-4_5_7_scaling";
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        auto list = [&](std::vector<int> &values) {
+            if (++i < argc && parseList(argv[i], values))
+                return true;
+            std::cerr << "\nError: " << option << " needs a comma-separated list of integers.\n";
+            return false;
+        };
+        if (option == "--bits") { if (!list(bits)) return 1; }
+        else if (option == "--threads") { if (!list(threads)) return 1; }
+        else if (option == "-d") { if (!list(depths)) return 1; }
+        else if (option == "-t") { if (!list(task_limits)) return 1; }
+        else if (option == "-q") { if (!list(queue_limits)) return 1; }
+        else if (option == "--seed") {
+            if (++i < argc) {
+                try { seed = std::stoul(argv[i]); }
+                catch (...) { std::cerr << "\nError: The --seed argument must be an integer.\n"; return 1; }
+            } else { std::cerr << "\nError: Missing argument for --seed option.\n"; return 1; }
+        } else if (option == "--reps") {
+            if (++i < argc) {
+                try { reps = std::max(1, std::stoi(argv[i])); }
+                catch (...) { std::cerr << "\nError: The --reps argument must be an integer.\n"; return 1; }
+            } else { std::cerr << "\nError: Missing argument for --reps option.\n"; return 1; }
+        } else if (option == "-o") {
+            if (++i < argc) { prefix = argv[i]; }
+            else { std::cerr << "\nError: Missing argument for -o option.\n"; return 1; }
+        } else if (!option.empty() && option[0] == '-') {
+            std::cerr << "\nError: Unknown option " << option << std::endl;
+            return 1;
+        } else
+            files.push_back(option);
+    }
+    if (files.empty() && bits.empty()) {
+        std::cerr << "\nUsage: " << argv[0] << " [dimacs_file ...] [--bits b1,b2,... [--seed n]] [--threads n1,n2,...]"
+                  << " [-d d1,d2,...] [-t t1,t2,...] [-q q1,q2,...] [--reps n] [-o prefix]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Instance> instances;
+    for (const auto &file : files) {
+        Instance instance;
+        if (!loadInstance(std::filesystem::path(file).filename().string(), readFileToString(file), instance)) {
+            std::cerr << "\nError: " << file << " is not a Purdom-Sabry factoring DIMACS file.\n";
+            return 1;
+        }
+        instances.push_back(std::move(instance));
+    }
+    for (int b : bits) {
+        if (b < 4) { std::cerr << "\nError: --bits needs at least 4 bits.\n"; return 1; }
+        big_int p, q;
+        randomSemiprime(b, seed, p, q);
+        std::string dimacs = FactoringCnf::dimacs(p * q, static_cast<int>(mpz_sizeinbase(p.get_mpz_t(), 2)),
+                                                  static_cast<int>(mpz_sizeinbase(q.get_mpz_t(), 2)));
+        Instance instance;
+        loadInstance("rsaFACT-" + std::to_string(b) + "bit-" + std::to_string(seed), dimacs, instance);
+        instances.push_back(std::move(instance));
+    }
+
+    int total_cores = get_processor_count();
+    if (threads.empty()) {
+        for (int t = 1; t < total_cores; t *= 2)
+            threads.push_back(t);
+        threads.push_back(total_cores);
+    }
+    std::sort(threads.begin(), threads.end());
+    threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+    if (threads.front() < 1) { std::cerr << "\nError: Thread counts must be 1 or greater.\n"; return 1; }
+    std::vector<Split> splits;
+    for (int d : depths) splits.push_back({'d', d});
+    for (int t : task_limits) splits.push_back({'t', t});
+    for (int q : queue_limits) splits.push_back({'q', q});
+    if (splits.empty())
+        splits.push_back({'a', 0});
+
+    std::string runs_path = prefix + "-runs.csv", scaling_path = prefix + "-scaling.csv";
+    std::ofstream runs_csv(runs_path, std::ios::trunc);
+    std::ofstream scaling_csv(scaling_path, std::ios::trunc);
+    if (!runs_csv || !scaling_csv) {
+        std::cerr << "\nError: Could not write " << runs_path << " / " << scaling_path << std::endl;
+        return 1;
+    }
+    runs_csv << "instance,bits,clauses,split,threads,rep,bfs_seconds,dfs_seconds,wall_seconds,bfs_depth,tasks,nodes,nodes_per_second,result\n";
+    scaling_csv << "instance,bits,split,threads,reps,median_wall_seconds,min_wall_seconds,median_bfs_seconds,median_dfs_seconds,"
+                   "median_nodes_per_second,speedup,efficiency\n";
+
+    ProgressConfig quiet;   // process_queue runs the progress reporter; keep it off the console
+    quiet.quiet = true;
+    progress.configure(quiet);
+    std::cout << version << std::endl;
+    std::cout << "\n Total Cores: " << total_cores << std::endl;
+    std::cout << "   Instances: " << instances.size() << " - Splits: " << splits.size() << " - Threads: " << threads.size()
+              << " - Repetitions: " << reps << std::endl;
+    #pragma omp parallel
+    { }
+
+    for (const Instance &instance : instances) {
+        for (const Split &split : splits) {
+            std::cout << "\n    Instance: " << instance.name << " (" << instance.num_bits << " bits, " << instance.input_number
+                      << ") - Split: " << split.name() << std::endl;
+            std::map<int, std::vector<Run>> runs;   // per thread count
+            for (int rep = 0; rep < reps; ++rep)
+                for (int t : threads) {
+                    Run run = runOnce(instance, split, t);
+                    runs[t].push_back(run);
+                    runs_csv << instance.name << ',' << instance.num_bits << ',' << instance.clauses.size() << ',' << split.name()
+                             << ',' << t << ',' << rep << ',' << run.bfs_seconds << ',' << run.dfs_seconds << ',' << run.wall()
+                             << ',' << run.depth << ',' << run.tasks << ',' << run.nodes << ',' << run.nodesPerSecond()
+                             << ',' << run.result << std::endl;
+                    if (std::string(run.result) == "FALSE")
+                        std::cerr << "\nError: " << instance.name << " gave a wrong factorization with " << t << " threads\n";
+                }
+            double base_wall = 0;
+            for (int t : threads) {
+                std::vector<double> wall, bfs, dfs, rate;
+                for (const Run &run : runs[t]) {
+                    wall.push_back(run.wall());
+                    bfs.push_back(run.bfs_seconds);
+                    dfs.push_back(run.dfs_seconds);
+                    rate.push_back(run.nodesPerSecond());
+                }
+                double median_wall = median(wall);
+                if (t == threads.front())
+                    base_wall = median_wall;
+                double speedup = median_wall > 0 ? base_wall / median_wall : 0.0;
+                double efficiency = speedup * threads.front() / t;
+                scaling_csv << instance.name << ',' << instance.num_bits << ',' << split.name() << ',' << t << ',' << reps
+                            << ',' << median_wall << ',' << *std::min_element(wall.begin(), wall.end()) << ',' << median(bfs)
+                            << ',' << median(dfs) << ',' << median(rate) << ',' << speedup << ',' << efficiency << std::endl;
+                std::cout << "     Threads: " << std::setw(3) << t << " - Wall: " << median_wall << " s (BFS " << median(bfs)
+                          << " s, DFS " << median(dfs) << " s) - Nodes/s: " << static_cast<std::uint64_t>(median(rate))
+                          << " - Speedup: " << std::setprecision(3) << speedup << " - Efficiency: " << efficiency
+                          << std::setprecision(6) << std::endl;
+            }
+        }
+    }
+    std::cout << "\nRuns saved: " << runs_path << std::endl;
+    std::cout << "Scaling saved: " << scaling_path << std::endl;
+    return 0;
+}
@@ -0,0 +1,290 @@
+// Numa.hpp
+//
+// NUMA-Aware Worker Placement for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// Linux only, switched on with --pin compact|scatter. The NUMA nodes and their CPUs
+// come from /sys/devices/system/node (restricted to the CPUs the process may run on);
+// without that directory all CPUs form one node. The reserved cores of -r are real
+// CPUs here, taken evenly from every node, lowest CPU numbers first (CPU 0 gets most
+// of the interrupts). Worker t is pinned to the t-th remaining CPU: compact fills one
+// node after the other, scatter deals the workers out over the nodes in turn. Helper
+// threads (the --stream producer, the progress reporter) are started with the reserved
+// CPUs as their mask, or with all CPUs if none are reserved, not with the CPU of worker 0
+// that the main thread is pinned to.
+//
+// NodeQueues holds one task queue per node; a worker takes from the queue of its own
+// node and only steals from the others when that is empty. A worker on another node
+// than the BFS copies the clause set of its task before solving it, so the pages are
+// first-touched (allocated) on the worker's node instead of being read across the
+// interconnect for the whole DFS.
+//
+#ifndef NUMA_HPP
+#define NUMA_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <cerrno>
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+namespace numa {
+
+enum class Policy { None, Compact, Scatter };
+
+// "0-3,8,10-11" -> 0 1 2 3 8 10 11 (the format of the sysfs cpulist files).
+inline std::vector<int> parseCpuList(const std::string &text) {
+        std::vector<int> cpus;
+        std::istringstream in(text);
+        std::string range;
+        while (std::getline(in, range, ',')) {
+                std::size_t dash = range.find('-');
+                try {
+                        int first = std::stoi(range.substr(0, dash));
+                        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                        for (int cpu = first; cpu <= last; ++cpu)
+                                cpus.push_back(cpu);
+                } catch (...) { }
+        }
+        return cpus;
+}
+
+// Usable CPUs per NUMA node, ascending; empty if the CPUs cannot be determined.
+inline std::vector<std::vector<int>> detectNodes(std::string &error) {
+        std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+                error = std::string("sched_getaffinity: ") + std::strerror(errno);
+                return nodes;
+        }
+        std::vector<int> node_ids;
+        if (DIR *dir = opendir("/sys/devices/system/node")) {
+                while (dirent *entry = readdir(dir)) {
+                        std::string name = entry->d_name;
+                        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                            name.find_first_not_of("0123456789", 4) == std::string::npos)
+                                node_ids.push_back(std::stoi(name.substr(4)));
+                }
+                closedir(dir);
+        }
+        std::sort(node_ids.begin(), node_ids.end());
+        for (int id : node_ids) {
+                std::ifstream file("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+                std::string list;
+                std::getline(file, list);
+                std::vector<int> cpus;
+                for (int cpu : parseCpuList(list))
+                        if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+                                cpus.push_back(cpu);
+                if (!cpus.empty())   // memory-only nodes have no CPUs
+                        nodes.push_back(cpus);
+        }
+        if (nodes.empty()) {   // no sysfs: one node with every allowed CPU
+                std::vector<int> cpus;
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                        if (CPU_ISSET(cpu, &allowed))
+                                cpus.push_back(cpu);
+                nodes.push_back(cpus);
+        }
+#else
+        error = "thread pinning is Linux only";
+#endif
+        return nodes;
+}
+
+// Which CPU and node every worker thread runs on.
+class Placement {
+public:
+        // False (with the reason) if the topology cannot be read; the workers then stay unpinned.
+        bool configure(Policy policy, int workers, int reserve, std::string &error) {
+                nodes_ = detectNodes(error);
+                if (nodes_.empty())
+                        return false;
+                std::vector<std::size_t> first(nodes_.size(), 0);   // reserved CPUs per node
+                for (int r = 0; r < reserve; ++r) {
+                        std::size_t n = static_cast<std::size_t>(r) % nodes_.size();
+                        if (first[n] < nodes_[n].size())
+                                reserved_.push_back(nodes_[n][first[n]++]);
+                }
+                for (std::size_t n = 0; n < nodes_.size(); ++n)
+                        nodes_[n].erase(nodes_[n].begin(), nodes_[n].begin() + first[n]);
+                if (policy == Policy::Compact) {
+                        for (std::size_t n = 0; n < nodes_.size(); ++n)
+                                for (int cpu : nodes_[n])
+                                        slots_.push_back({cpu, static_cast<int>(n)});
+                } else {
+                        for (std::size_t k = 0; slots_.size() < totalCpus(); ++k)
+                                for (std::size_t n = 0; n < nodes_.size(); ++n)
+                                        if (k < nodes_[n].size())
+                                                slots_.push_back({nodes_[n][k], static_cast<int>(n)});
+                }
+                if (slots_.empty()) {
+                        error = "no CPU left after reserving " + std::to_string(reserve);
+                        return false;
+                }
+#ifdef __linux__
+                CPU_ZERO(&helpers_);
+                for (int cpu : reserved_)
+                        CPU_SET(cpu, &helpers_);
+                if (reserved_.empty())
+                        for (const Slot &slot : slots_)
+                                CPU_SET(slot.cpu, &helpers_);
+#endif
+                policy_ = policy;
+                workers_ = workers;
+                return true;
+        }
+
+        bool enabled() const { return policy_ != Policy::None; }
+        int nodes() const { return static_cast<int>(nodes_.size()); }
+        int cpu(int worker) const { return slots_[static_cast<std::size_t>(worker) % slots_.size()].cpu; }
+        int node(int worker) const { return enabled() ? slots_[static_cast<std::size_t>(worker) % slots_.size()].node : 0; }
+
+        bool pinCurrentThread(int worker) const {
+#ifdef __linux__
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu(worker), &set);
+                return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+                (void)worker;
+                return false;
+#endif
+        }
+
+        // Calls spawn() with the calling (pinned) thread's mask widened to the helper CPUs, so
+        // the thread it starts does not inherit one worker's CPU; the mask is restored after.
+        template <class Spawn>
+        void spawnHelper(Spawn spawn) const {
+#ifdef __linux__
+                cpu_set_t own;
+                if (enabled() && sched_getaffinity(0, sizeof(own), &own) == 0 &&
+                    sched_setaffinity(0, sizeof(helpers_), &helpers_) == 0) {
+                        spawn();
+                        sched_setaffinity(0, sizeof(own), &own);
+                        return;
+                }
+#endif
+                spawn();
+        }
+
+        // e.g. "scatter - 2 NUMA nodes - workers per node 3/3 - reserved CPUs 0, 4"
+        std::string describe() const {
+                std::vector<int> per_node(nodes_.size(), 0);
+                for (int t = 0; t < workers_; ++t)
+                        ++per_node[static_cast<std::size_t>(node(t))];
+                std::ostringstream out;
+                out << (policy_ == Policy::Compact ? "compact" : "scatter") << " - " << nodes_.size()
+                    << (nodes_.size() == 1 ? " NUMA node" : " NUMA nodes") << " - workers per node ";
+                for (std::size_t n = 0; n < per_node.size(); ++n)
+                        out << (n ? "/" : "") << per_node[n];
+                if (static_cast<std::size_t>(workers_) > slots_.size())
+                        out << " (" << slots_.size() << " CPUs, shared)";
+                if (!reserved_.empty()) {
+                        out << " - reserved CPUs ";
+                        for (std::size_t k = 0; k < reserved_.size(); ++k)
+                                out << (k ? ", " : "") << reserved_[k];
+                }
+                return out.str();
+        }
+
+private:
+        struct Slot {
+                int cpu;
+                int node;
+        };
+        Policy policy_ = Policy::None;
+        int workers_ = 0;
+        std::vector<std::vector<int>> nodes_;
+        std::vector<Slot> slots_;   // worker t runs on slots_[t % size]
+        std::vector<int> reserved_;
+#ifdef __linux__
+        cpu_set_t helpers_;   // mask of threads started by spawnHelper()
+#endif
+
+        std::size_t totalCpus() const {
+                std::size_t total = 0;
+                for (const auto &cpus : nodes_)
+                        total += cpus.size();
+                return total;
+        }
+};
+
+// One FIFO per NUMA node with its own lock, so the sockets do not contend for one mutex.
+// pop() takes from the given node first, then from the next nodes in turn.
+template <class T>
+class NodeQueues {
+public:
+        explicit NodeQueues(int nodes) {
+                for (int n = 0; n < std::max(nodes, 1); ++n)
+                        lanes_.push_back(std::make_unique<Lane>());
+        }
+
+        void push(int node, T item) {
+                Lane &lane = *lanes_[static_cast<std::size_t>(node) % lanes_.size()];
+                std::lock_guard<std::mutex> lock(lane.mutex);
+                lane.items.push_back(std::move(item));
+                size_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        bool pop(int node, T &item) {
+                for (std::size_t k = 0; k < lanes_.size(); ++k) {
+                        Lane &lane = *lanes_[(static_cast<std::size_t>(node) + k) % lanes_.size()];
+                        std::lock_guard<std::mutex> lock(lane.mutex);
+                        if (lane.items.empty())
+                                continue;
+                        item = std::move(lane.items.front());
+                        lane.items.pop_front();
+                        size_.fetch_sub(1, std::memory_order_relaxed);
+                        return true;
+                }
+                return false;
+        }
+
+        std::size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+private:
+        struct alignas(64) Lane {
+                std::mutex mutex;
+                std::deque<T> items;
+        };
+        std::vector<std::unique_ptr<Lane>> lanes_;
+        std::atomic<std::size_t> size_{0};
+};
+
+} // namespace numa
+
+#endif // NUMA_HPP
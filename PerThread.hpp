@@ -0,0 +1,94 @@
+// PerThread.hpp
+//
+// Per-Thread Statistics Slots for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// The bookkeeping shared by the profiler (Profiler.hpp), the timeline trace (Trace.hpp),
+// the hardware counters (PerfCounters.hpp) and the progress reporter (Progress.hpp):
+// every thread gets its own slot, registered under a lock on first use and then written
+// by that thread alone. The slots are owned by the registry, not by the threads, so
+// short-lived threads (BFS producer, reporter) still count when the slots are summed.
+//
+// Counters in a slot are atomics written by one thread only: relaxedAdd() is a relaxed
+// load and store, which keeps the concurrent reads race-free without the lock prefix
+// (and cache line ping-pong) of fetch_add.
+//
+#ifndef PER_THREAD_HPP
+#define PER_THREAD_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+inline void relaxedAdd(std::atomic<std::uint64_t> &counter, std::uint64_t delta) {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline void relaxedMax(std::atomic<std::uint64_t> &counter, std::uint64_t value) {
+        if (value > counter.load(std::memory_order_relaxed))
+                counter.store(value, std::memory_order_relaxed);
+}
+
+// One T per thread. The slot pointer is a thread_local per T, so a program has one
+// PerThread<T> per slot type.
+template <class T>
+class PerThread {
+public:
+        // Slot of the calling thread, built with make() on first use. make() may return
+        // nullptr: nothing is registered and the thread gets nullptr from then on.
+        template <class Make>
+        T *local(Make make) {
+                if (!tried_) {
+                        tried_ = true;
+                        if (std::unique_ptr<T> slot = make()) {
+                                std::lock_guard<std::mutex> lock(mutex_);
+                                slots_.push_back(std::move(slot));
+                                local_ = slots_.back().get();
+                        }
+                }
+                return local_;
+        }
+
+        T &local() {
+                return *local([]() { return std::make_unique<T>(); });
+        }
+
+        // Calls f(const T &) for the slots of all threads so far; their owners may still be writing.
+        template <class F>
+        void forEach(F f) const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (const auto &slot : slots_)
+                        f(*slot);
+        }
+
+private:
+        mutable std::mutex mutex_;
+        std::vector<std::unique_ptr<T>> slots_;
+        static inline thread_local T *local_ = nullptr;
+        static inline thread_local bool tried_ = false;
+};
+
+#endif // PER_THREAD_HPP
@@ -0,0 +1,258 @@
+// PerfCounters.hpp
+//
+// Hardware Performance Counters for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// Linux only, switched on with --perf. Every thread that enters a region opens its own
+// perf_event_open group (cycles, instructions, L1D read misses, LLC misses, branch
+// misses; user space only) and reads it with one read() at the start and the end of
+// the region. Regions: the BFS, every DFS task, and the resolution kernel - the latter
+// is only read on every 64th call and scaled up, a read costs about a microsecond.
+// The per-thread sums are added up when the results are dumped. Without permission
+// (perf_event_paranoid, containers, no PMU in the VM) enable() reports why and every
+// region becomes a no-op; counters the CPU lacks are shown as n/a.
+//
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "PerThread.hpp"
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perf {
+
+enum Counter { Cycles, Instructions, L1dMisses, LlcMisses, BranchMisses, kCounters };
+enum Region { Bfs, DfsTask, Resolution, kRegions };
+
+inline const char *counterName(int c) {
+        static const char *names[kCounters] = {"Cycles", "Instructions", "L1D misses", "LLC misses", "Branch misses"};
+        return names[c];
+}
+
+inline const char *regionName(int r) {
+        static const char *names[kRegions] = {"BFS", "DFS tasks", "Resolution kernel (1/64 sampled)"};
+        return names[r];
+}
+
+constexpr unsigned kResolutionSampling = 64;
+
+struct Reading {
+        std::uint64_t value[kCounters] = {};
+        std::uint64_t enabled = 0, running = 0;   // for multiplexed groups
+};
+
+// One counter group of the calling thread.
+class ThreadGroup {
+public:
+        ThreadGroup() { for (int &fd : fds_) fd = -1; }
+        ~ThreadGroup() { close(); }
+        ThreadGroup(const ThreadGroup &) = delete;
+        ThreadGroup &operator=(const ThreadGroup &) = delete;
+
+        // False (with the reason) if not even the cycle counter can be opened.
+        bool open(std::string &error) {
+#ifdef __linux__
+                static const std::uint32_t types[kCounters] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                                              PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE};
+                static const std::uint64_t configs[kCounters] = {
+                        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+                for (int c = 0; c < kCounters; ++c) {
+                        perf_event_attr attr;
+                        std::memset(&attr, 0, sizeof(attr));
+                        attr.size = sizeof(attr);
+                        attr.type = types[c];
+                        attr.config = configs[c];
+                        attr.exclude_kernel = 1;
+                        attr.exclude_hv = 1;
+                        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, c == 0 ? -1 : fds_[0], 0));
+                        if (fd < 0 && c == 0) {
+                                error = std::string("perf_event_open: ") + std::strerror(errno);
+                                return false;
+                        }
+                        fds_[c] = fd;
+                        if (fd >= 0)
+                                order_.push_back(c);
+                }
+                return true;
+#else
+                error = "perf_event_open is Linux only";
+                return false;
+#endif
+        }
+
+        bool available(int c) const { return fds_[c] >= 0; }
+
+        bool read(Reading &r) const {
+#ifdef __linux__
+                std::uint64_t buffer[3 + kCounters];
+                ssize_t n = ::read(fds_[0], buffer, sizeof(buffer));
+                if (n < static_cast<ssize_t>(3 * sizeof(std::uint64_t)) || buffer[0] != order_.size())
+                        return false;
+                r.enabled = buffer[1];
+                r.running = buffer[2];
+                for (std::size_t k = 0; k < order_.size(); ++k)
+                        r.value[order_[k]] = buffer[3 + k];
+                return true;
+#else
+                (void)r;
+                return false;
+#endif
+        }
+
+private:
+        int fds_[kCounters];
+        std::vector<int> order_;   // counters in group read order
+
+        void close() {
+#ifdef __linux__
+                for (int fd : fds_)
+                        if (fd >= 0)
+                                ::close(fd);
+#endif
+        }
+};
+
+// Sums of one thread (a PerThread slot), read by the dump.
+struct ThreadSums {
+        ThreadGroup group;
+        std::atomic<std::uint64_t> value[kRegions][kCounters] = {};
+        std::atomic<std::uint64_t> calls[kRegions] = {};
+        std::uint64_t entered[kRegions] = {};   // for the sampling of the resolution kernel
+};
+
+class Counters {
+public:
+        static Counters &instance() {
+                static Counters counters;
+                return counters;
+        }
+
+        // Probe on the calling thread; on failure all regions stay no-ops.
+        bool enable(std::string &error) {
+                bool ok = local(&error) != nullptr;
+                enabled_.store(ok, std::memory_order_relaxed);
+                return ok;
+        }
+        bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+        // The group of the calling thread, opened on first use; nullptr if that failed.
+        ThreadSums *local(std::string *error = nullptr) {
+                return threads_.local([error]() {
+                        auto sums = std::make_unique<ThreadSums>();
+                        std::string reason;
+                        if (!sums->group.open(reason))
+                                sums.reset();
+                        if (error)
+                                *error = reason;
+                        return sums;
+                });
+        }
+
+        struct Total {
+                std::uint64_t value[kCounters] = {};
+                bool available[kCounters] = {};
+                std::uint64_t calls = 0;
+        };
+
+        std::vector<Total> totals() {
+                std::vector<Total> result(kRegions);
+                threads_.forEach([&](const ThreadSums &thread) {
+                        for (int r = 0; r < kRegions; ++r) {
+                                result[r].calls += thread.calls[r].load(std::memory_order_relaxed);
+                                for (int c = 0; c < kCounters; ++c) {
+                                        result[r].value[c] += thread.value[r][c].load(std::memory_order_relaxed);
+                                        result[r].available[c] = result[r].available[c] || thread.group.available(c);
+                                }
+                        }
+                });
+                return result;
+        }
+
+private:
+        std::atomic<bool> enabled_{false};
+        PerThread<ThreadSums> threads_;
+};
+
+// Adds the counts between construction and destruction to `region` of this thread.
+// every > 1: only every n-th entry is measured and counted n times.
+class Scope {
+public:
+        explicit Scope(Region region, unsigned every = 1) : region_(region) {
+                Counters &counters = Counters::instance();
+                if (!counters.enabled())
+                        return;
+                sums_ = counters.local();
+                if (!sums_)
+                        return;
+                if (every > 1 && sums_->entered[region]++ % every != 0) {
+                        sums_ = nullptr;
+                        return;
+                }
+                scale_ = every;
+                if (!sums_->group.read(start_))
+                        sums_ = nullptr;
+        }
+        ~Scope() { stop(); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        // Ends the region early (before code that never returns, like the solution report).
+        void stop() {
+                Reading end;
+                ThreadSums *sums = sums_;
+                sums_ = nullptr;
+                if (!sums || !sums->group.read(end))
+                        return;
+                std::uint64_t running = end.running - start_.running;
+                double multiplex = running ? static_cast<double>(end.enabled - start_.enabled) / static_cast<double>(running) : 1.0;
+                for (int c = 0; c < kCounters; ++c) {
+                        std::uint64_t delta = static_cast<std::uint64_t>(static_cast<double>(end.value[c] - start_.value[c]) * multiplex) * scale_;
+                        relaxedAdd(sums->value[region_][c], delta);
+                }
+                relaxedAdd(sums->calls[region_], scale_);
+        }
+
+private:
+        Region region_;
+        ThreadSums *sums_ = nullptr;
+        unsigned scale_ = 1;
+        Reading start_;
+};
+
+} // namespace perf
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,275 @@
+// Profiler.hpp
+//
+// Scope Profiler for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// Compiled in with -DENABLE_PROFILING, otherwise PROFILE_SCOPE expands to nothing.
+// Every PROFILE_SCOPE site gets its ID at compile time (__COUNTER__). Each thread owns
+// a fixed array of counters (ticks, calls, log-bucketed latency histogram) indexed by
+// that ID, so a scope costs two time stamps (rdtsc on x86, steady_clock elsewhere) and
+// three thread-local adds - no strings, no maps, no locks. The per-thread arrays are
+// only summed when the results are dumped (total, average, p50/p90/p99/max).
+//
+// TaskTimes is always compiled in: one record per DFS task (BFS cube) with its solve
+// time, for the p50/p90/p99/max summary line and the optional CSV export that shows
+// whether the frontier split is balanced.
+//
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "PerThread.hpp"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace profiling {
+
+constexpr int kMaxScopes = 64;   // PROFILE_SCOPE sites per program
+
+inline std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// HDR-style log-bucketed histogram: values below 8 are exact, above that every power of
+// two is split into 8 sub-buckets, so a percentile is off by at most 12.5%.
+namespace histogram {
+        constexpr int kSubBuckets = 8;
+        constexpr int kBuckets = kSubBuckets + 61 * kSubBuckets;   // up to 2^64
+
+        inline int bucket(std::uint64_t v) {
+                if (v < kSubBuckets)
+                        return static_cast<int>(v);
+#ifdef __GNUC__
+                int e = 63 - __builtin_clzll(v);
+#else
+                int e = 0;
+                while (v >> (e + 1))
+                        ++e;
+#endif
+                return (e - 2) * kSubBuckets + static_cast<int>((v >> (e - 3)) & (kSubBuckets - 1));
+        }
+
+        inline std::uint64_t lowest(int b) {
+                if (b < kSubBuckets)
+                        return static_cast<std::uint64_t>(b);
+                int e = b / kSubBuckets + 2;
+                return static_cast<std::uint64_t>(kSubBuckets + b % kSubBuckets) << (e - 3);
+        }
+}
+
+class LogHistogram {
+public:
+        void add(std::uint64_t v, std::uint64_t n = 1) {
+                counts_[histogram::bucket(v)] += n;
+                count_ += n;
+                max_ = std::max(max_, v);
+        }
+        void addBucket(int b, std::uint64_t n) {
+                counts_[b] += n;
+                count_ += n;
+        }
+        void raiseMax(std::uint64_t v) { max_ = std::max(max_, v); }
+
+        std::uint64_t count() const { return count_; }
+        std::uint64_t max() const { return max_; }
+
+        // Highest value of the bucket holding the q-quantile (0 < q <= 1), capped at the max.
+        std::uint64_t percentile(double q) const {
+                if (count_ == 0)
+                        return 0;
+                std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(count_) + 0.999999);
+                rank = std::max<std::uint64_t>(1, std::min(rank, count_));
+                std::uint64_t seen = 0;
+                for (int b = 0; b < histogram::kBuckets; ++b) {
+                        seen += counts_[b];
+                        if (seen >= rank)
+                                return b + 1 < histogram::kBuckets ? std::min(max_, histogram::lowest(b + 1) - 1) : max_;
+                }
+                return max_;
+        }
+
+private:
+        std::uint64_t counts_[histogram::kBuckets] = {};
+        std::uint64_t count_ = 0;
+        std::uint64_t max_ = 0;
+};
+
+// Written by its own thread only (PerThread.hpp), read by the dump.
+struct Slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<std::uint64_t> ticks{0};
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> max{0};
+        std::atomic<std::uint64_t> buckets[histogram::kBuckets] = {};
+};
+
+struct alignas(64) ThreadSlots {
+        Slot slots[kMaxScopes];
+};
+
+// Owns the slot arrays of all threads that ever entered a scope.
+class Registry {
+public:
+        static Registry &instance() {
+                static Registry registry;
+                return registry;
+        }
+
+        ThreadSlots &local() { return threads_.local(); }
+
+        struct Total {
+                const char *name;
+                std::uint64_t ticks;
+                std::uint64_t calls;
+                LogHistogram latency;   // ticks per call
+        };
+
+        // Sum over threads, one entry per scope that was entered, most expensive first.
+        std::vector<Total> totals() {
+                std::vector<Total> result;
+                for (int id = 0; id < kMaxScopes; ++id) {
+                        Total total{nullptr, 0, 0, {}};
+                        threads_.forEach([&](const ThreadSlots &thread) {
+                                const Slot &slot = thread.slots[id];
+                                if (const char *name = slot.name.load(std::memory_order_relaxed))
+                                        total.name = name;
+                                total.ticks += slot.ticks.load(std::memory_order_relaxed);
+                                total.calls += slot.calls.load(std::memory_order_relaxed);
+                                total.latency.raiseMax(slot.max.load(std::memory_order_relaxed));
+                                for (int b = 0; b < histogram::kBuckets; ++b)
+                                        if (std::uint64_t n = slot.buckets[b].load(std::memory_order_relaxed))
+                                                total.latency.addBucket(b, n);
+                        });
+                        if (total.name)
+                                result.push_back(total);
+                }
+                std::sort(result.begin(), result.end(), [](const Total &a, const Total &b) { return a.ticks > b.ticks; });
+                return result;
+        }
+
+        // Tick length calibrated against steady_clock over the lifetime of the registry.
+        double secondsPerTick() const {
+                std::uint64_t elapsed_ticks = ticks() - start_ticks_;
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
+                return elapsed_ticks ? elapsed / static_cast<double>(elapsed_ticks) : 0.0;
+        }
+
+private:
+        Registry() : start_ticks_(ticks()), start_time_(std::chrono::steady_clock::now()) { }
+
+        PerThread<ThreadSlots> threads_;
+        std::uint64_t start_ticks_;
+        std::chrono::steady_clock::time_point start_time_;
+};
+
+template <int Id>
+class Scope {
+        static_assert(Id < kMaxScopes, "raise profiling::kMaxScopes");
+public:
+        explicit Scope(const char *name) : slot_(Registry::instance().local().slots[Id]), start_(ticks()) {
+                slot_.name.store(name, std::memory_order_relaxed);
+        }
+        ~Scope() {
+                std::uint64_t elapsed = ticks() - start_;
+                relaxedAdd(slot_.ticks, elapsed);
+                relaxedAdd(slot_.calls, 1);
+                relaxedAdd(slot_.buckets[histogram::bucket(elapsed)], 1);
+                relaxedMax(slot_.max, elapsed);
+        }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+private:
+        Slot &slot_;
+        std::uint64_t start_;
+};
+
+// Solve time of every DFS task. One record per task, so a mutex is cheap enough here.
+class TaskTimes {
+public:
+        struct Record {
+                long long task;        // queue position (stream mode: pop order)
+                int thread;
+                std::size_t cube;      // literals fixed by the BFS
+                double seconds;
+                const char *outcome;   // "unsat", "conflict", "solution"
+        };
+
+        void configure(const std::string &csv_path) { path_ = csv_path; }
+        const std::string &path() const { return path_; }
+
+        void record(const Record &r) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                records_.push_back(r);
+        }
+
+        LogHistogram histogram() {   // nanoseconds
+                std::lock_guard<std::mutex> lock(mutex_);
+                LogHistogram h;
+                for (const auto &r : records_)
+                        h.add(static_cast<std::uint64_t>(r.seconds * 1e9));
+                return h;
+        }
+
+        bool exportCsv() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::ofstream out(path_, std::ios::trunc);
+                if (!out)
+                        return false;
+                out << "task,thread,cube_literals,seconds,outcome\n";
+                for (const auto &r : records_)
+                        out << r.task << ',' << r.thread << ',' << r.cube << ',' << r.seconds << ',' << r.outcome << '\n';
+                return static_cast<bool>(out);
+        }
+
+private:
+        std::mutex mutex_;
+        std::vector<Record> records_;
+        std::string path_;
+};
+
+} // namespace profiling
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE_ID_(name, id) profiling::Scope<id> PROFILE_CONCAT(profile_scope_, id)(name)
+
+#ifdef ENABLE_PROFILING
+#define PROFILE_SCOPE(name) PROFILE_SCOPE_ID_(name, __COUNTER__)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+#endif // PROFILER_HPP
@@ -0,0 +1,283 @@
+// Progress.hpp
+//
+// Progress Reporting for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// The solver only bumps relaxed atomic counters (ProgressCounters); a reporter thread
+// samples them every interval and owns all progress output: the "Queue size" line of
+// the BFS, the "DFS time" / "Lap time" lines of the DFS, and optionally a machine-
+// readable log with one JSON object per sample. Quiet mode drops the terminal lines,
+// the log is written either way.
+//
+// Search statistics (nodes, decisions, propagations, conflicts, maximum depth, clauses
+// processed, bytes allocated) are kept per worker thread: the DFS counts in locals and
+// adds them to its thread's WorkerStats every few thousand nodes; the reporter sums the
+// workers for the live nodes/s and conflicts/s and for the summary of the result file.
+//
+#ifndef PROGRESS_HPP
+#define PROGRESS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PerThread.hpp"
+
+struct ProgressCounters {
+        std::atomic<std::uint64_t> bfs_tasks{0};    // tasks created by the BFS
+        std::atomic<std::uint64_t> bfs_queue{0};    // current BFS frontier size
+        std::atomic<std::uint64_t> bfs_depth{0};    // BFS expansions
+        std::atomic<std::uint64_t> dfs_finished{0}; // DFS tasks searched completely
+        std::atomic<std::uint64_t> dfs_pending{0};  // DFS tasks not yet taken by a thread
+};
+
+// Statistics of (part of) a DFS run.
+struct SearchStats {
+        std::uint64_t nodes = 0;
+        std::uint64_t decisions = 0;      // free splits
+        std::uint64_t propagations = 0;   // splits on a unit clause
+        std::uint64_t conflicts = 0;
+        std::uint64_t max_depth = 0;      // longest assignment (literals) of a node
+        std::uint64_t clauses = 0;        // clauses scanned by the resolution step
+        std::uint64_t bytes = 0;          // clause set bytes allocated by the resolution step
+
+        void add(const SearchStats &other) {
+                nodes += other.nodes;
+                decisions += other.decisions;
+                propagations += other.propagations;
+                conflicts += other.conflicts;
+                max_depth = std::max(max_depth, other.max_depth);
+                clauses += other.clauses;
+                bytes += other.bytes;
+        }
+};
+
+// Totals of one worker thread (a PerThread slot), read by the reporter.
+struct alignas(64) WorkerStats {
+        explicit WorkerStats(int worker) : id(worker) { }
+
+        const int id;
+        std::atomic<std::uint64_t> nodes{0}, decisions{0}, propagations{0}, conflicts{0}, max_depth{0}, clauses{0}, bytes{0};
+
+        void add(const SearchStats &s) {
+                relaxedAdd(nodes, s.nodes);
+                relaxedAdd(decisions, s.decisions);
+                relaxedAdd(propagations, s.propagations);
+                relaxedAdd(conflicts, s.conflicts);
+                relaxedAdd(clauses, s.clauses);
+                relaxedAdd(bytes, s.bytes);
+                relaxedMax(max_depth, s.max_depth);
+        }
+        SearchStats load() const {
+                SearchStats s;
+                s.nodes = nodes.load(std::memory_order_relaxed);
+                s.decisions = decisions.load(std::memory_order_relaxed);
+                s.propagations = propagations.load(std::memory_order_relaxed);
+                s.conflicts = conflicts.load(std::memory_order_relaxed);
+                s.max_depth = max_depth.load(std::memory_order_relaxed);
+                s.clauses = clauses.load(std::memory_order_relaxed);
+                s.bytes = bytes.load(std::memory_order_relaxed);
+                return s;
+        }
+};
+
+struct ProgressConfig {
+        int interval_ms = 1000;
+        bool quiet = false;
+        std::string log_path;   // JSON lines, empty = no log
+};
+
+class ProgressReporter {
+public:
+        enum class Phase { Idle, Bfs, Dfs };
+
+        ProgressCounters counters;
+
+        ~ProgressReporter() { stop(); }
+
+        void configure(const ProgressConfig &config) {
+                config_ = config;
+                if (!config_.log_path.empty()) {
+                        log_.open(config_.log_path, std::ios::trunc);
+                        if (!log_.is_open())
+                                std::cerr << "\nError: Could not open progress log " << config_.log_path << std::endl;
+                }
+        }
+        bool quiet() const { return config_.quiet; }
+
+        // Statistics slot of the calling thread, registered under `id` on first use
+        // (one reporter per program).
+        WorkerStats &worker(int id) {
+                return *workers_.local([id]() { return std::make_unique<WorkerStats>(id); });
+        }
+
+        // Sums per worker ID (threads that share an ID are added up).
+        std::map<int, SearchStats> workerTotals() {
+                std::map<int, SearchStats> totals;
+                workers_.forEach([&](const WorkerStats &worker) { totals[worker.id].add(worker.load()); });
+                return totals;
+        }
+
+        SearchStats totals() {
+                SearchStats sum;
+                for (const auto &worker : workerTotals())
+                        sum.add(worker.second);
+                return sum;
+        }
+
+        // Runs on the reporter thread after every sample.
+        void onSample(std::function<void()> hook) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                hooks_.push_back(std::move(hook));
+        }
+
+        // Finish the line of the current phase and report the new one from now on.
+        void phase(Phase next) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                sample();
+                if (phase_ == Phase::Bfs && !config_.quiet)
+                        std::cout << std::endl;
+                phase_ = next;
+                phase_start_ = std::chrono::steady_clock::now();
+                lap_start_ = phase_start_;
+                lap_pending_ = counters.dfs_pending.load(std::memory_order_relaxed);
+                first_lap_skipped_ = false;
+                rate_start_ = phase_start_;
+                rate_base_ = totals();
+                if (!thread_.joinable()) {
+                        start_ = phase_start_;
+                        stopping_ = false;
+                        thread_ = std::thread([this]() { run(); });
+                }
+        }
+
+        // Stop the reporter thread (one last log sample); only the first of several callers joins it.
+        void stop() {
+                {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        if (!thread_.joinable() || stopping_)
+                                return;
+                        stopping_ = true;
+                }
+                wake_.notify_all();
+                thread_.join();
+                std::lock_guard<std::mutex> lock(mutex_);
+                logSample();
+        }
+
+private:
+        ProgressConfig config_;
+        Phase phase_ = Phase::Idle;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::thread thread_;
+        bool stopping_ = false;
+        std::ofstream log_;
+        std::vector<std::function<void()>> hooks_;
+        std::chrono::steady_clock::time_point start_, phase_start_, lap_start_;
+        std::uint64_t lap_pending_ = 0;
+        bool first_lap_skipped_ = false;
+        std::chrono::steady_clock::time_point rate_start_;   // nodes/s and conflicts/s since the last sample
+        SearchStats rate_base_;
+        PerThread<WorkerStats> workers_;
+
+        void run() {
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (!stopping_) {
+                        wake_.wait_for(lock, std::chrono::milliseconds(config_.interval_ms), [this]() { return stopping_; });
+                        if (stopping_)
+                                break;
+                        sample();
+                        for (auto &hook : hooks_)
+                                hook();
+                }
+        }
+
+        static long long seconds(std::chrono::steady_clock::duration d) {
+                return std::chrono::duration_cast<std::chrono::seconds>(d).count();
+        }
+
+        void sample() {   // mutex_ held
+                auto now = std::chrono::steady_clock::now();
+                if (!config_.quiet && phase_ == Phase::Bfs) {
+                        std::cout << "\r  Queue size: " << counters.bfs_queue.load(std::memory_order_relaxed)
+                                  << " - Depth: " << counters.bfs_depth.load(std::memory_order_relaxed)
+                                  << " - Tasks: " << counters.bfs_tasks.load(std::memory_order_relaxed) << std::flush;
+                } else if (!config_.quiet && phase_ == Phase::Dfs) {
+                        std::uint64_t pending = counters.dfs_pending.load(std::memory_order_relaxed);
+                        SearchStats stats = totals();
+                        double elapsed = std::chrono::duration<double>(now - rate_start_).count();
+                        std::cout << "\033[2K\r    DFS time: " << seconds(now - phase_start_) << " seconds"
+                                  << " - Remaining Queue Size: " << pending;
+                        if (elapsed > 0)
+                                std::cout << " - Nodes/s: " << static_cast<std::uint64_t>((stats.nodes - rate_base_.nodes) / elapsed)
+                                          << " - Conflicts/s: " << static_cast<std::uint64_t>((stats.conflicts - rate_base_.conflicts) / elapsed);
+                        std::cout << std::flush;
+                        rate_start_ = now;
+                        rate_base_ = stats;
+                        if (pending != lap_pending_) {
+                                if (first_lap_skipped_)
+                                        std::cout << "\n    Lap time: " << lap_pending_ << " = " << seconds(now - lap_start_)
+                                                  << " seconds\n" << std::endl;
+                                first_lap_skipped_ = true;
+                                lap_pending_ = pending;
+                                lap_start_ = now;
+                        }
+                }
+                logSample();
+        }
+
+        void logSample() {   // mutex_ held
+                if (!log_.is_open() || phase_ == Phase::Idle)
+                        return;
+                double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+                SearchStats stats = totals();
+                log_ << "{\"t\":" << t << ",\"phase\":\"" << (phase_ == Phase::Bfs ? "bfs" : "dfs") << "\""
+                     << ",\"bfs_tasks\":" << counters.bfs_tasks.load(std::memory_order_relaxed)
+                     << ",\"bfs_queue\":" << counters.bfs_queue.load(std::memory_order_relaxed)
+                     << ",\"bfs_depth\":" << counters.bfs_depth.load(std::memory_order_relaxed)
+                     << ",\"dfs_nodes\":" << stats.nodes
+                     << ",\"dfs_decisions\":" << stats.decisions
+                     << ",\"dfs_propagations\":" << stats.propagations
+                     << ",\"dfs_conflicts\":" << stats.conflicts
+                     << ",\"dfs_max_depth\":" << stats.max_depth
+                     << ",\"dfs_clauses\":" << stats.clauses
+                     << ",\"dfs_bytes\":" << stats.bytes
+                     << ",\"dfs_finished\":" << counters.dfs_finished.load(std::memory_order_relaxed)
+                     << ",\"dfs_pending\":" << counters.dfs_pending.load(std::memory_order_relaxed) << "}\n";
+                log_.flush();
+        }
+};
+
+#endif // PROGRESS_HPP
@@ -0,0 +1,154 @@
+// Restarts.hpp
+//
+// Restart Policies for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// A RestartPolicy tells Satisfy_iterative when to drop its DFS stack and start again
+// from the task root. The root already has the BFS cube assigned, so a restart keeps
+// the cube as assumptions and only forgets the choices made below it. There are no
+// learnt clauses to carry over, so a restart only helps if the next run branches
+// differently (--branch vsids keeps its activities and --polarity saved its phases across restarts).
+// Every policy lets the runs grow without bound, so the search stays complete.
+//
+// A conflict is a branch of the DFS that failed. Its LBD is the number of decisions (splits
+// that were not forced by a unit clause) on the path, i.e. the LBD of the clause
+// a CDCL solver would learn from the decisions alone.
+//
+#ifndef RESTARTS_HPP
+#define RESTARTS_HPP
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+struct RestartConfig {
+        enum class Kind { None, Luby, Geometric, Lbd };
+        Kind kind = Kind::None;
+        std::uint64_t base = 100;       // conflicts in the first run (Luby unit)
+        double factor = 1.5;            // Geometric: growth per run; Lbd: growth of the minimum run
+        std::size_t lbd_window = 50;    // Lbd: conflicts in the recent average
+        double lbd_margin = 0.8;        // Lbd: restart if recent average * margin > global average
+};
+
+inline std::string restartName(const RestartConfig &config) {
+        std::ostringstream name;
+        switch (config.kind) {
+        case RestartConfig::Kind::Luby:
+                name << "Luby (unit " << config.base << " conflicts)";
+                break;
+        case RestartConfig::Kind::Geometric:
+                name << "geometric (" << config.base << " conflicts, x" << config.factor << ")";
+                break;
+        case RestartConfig::Kind::Lbd:
+                name << "LBD average (window " << config.lbd_window << ", K " << config.lbd_margin
+                     << ", runs >= " << config.base << " conflicts, x" << config.factor << ")";
+                break;
+        default:
+                name << "off";
+        }
+        return name.str();
+}
+
+// Luby sequence 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ..., i >= 0.
+inline std::uint64_t luby(std::uint64_t i) {
+        std::uint64_t size = 1, seq = 0;
+        while (size < i + 1) {
+                ++seq;
+                size = 2 * size + 1;
+        }
+        while (size - 1 != i) {
+                size = (size - 1) >> 1;
+                --seq;
+                i = i % size;
+        }
+        return std::uint64_t(1) << seq;
+}
+
+class RestartPolicy {
+public:
+        explicit RestartPolicy(const RestartConfig &config) : config_(config), recent_(config.lbd_window, 0) {
+                limit_ = nextLimit();
+        }
+
+        bool enabled() const { return config_.kind != RestartConfig::Kind::None; }
+        std::uint64_t restarts() const { return restarts_; }
+        std::uint64_t conflicts() const { return total_; }
+
+        // Record a conflict; true if the search should restart now.
+        bool conflict(unsigned lbd) {
+                ++total_;
+                ++run_;
+                if (config_.kind != RestartConfig::Kind::Lbd)
+                        return enabled() && run_ >= limit_;
+                global_sum_ += lbd;
+                recent_sum_ += lbd;
+                recent_sum_ -= recent_[next_];
+                recent_[next_] = lbd;
+                next_ = (next_ + 1) % recent_.size();
+                if (filled_ < recent_.size())
+                        ++filled_;
+                if (filled_ < recent_.size() || run_ < limit_)
+                        return false;
+                double recent = static_cast<double>(recent_sum_) / recent_.size();
+                double global = static_cast<double>(global_sum_) / total_;
+                return recent * config_.lbd_margin > global;
+        }
+
+        void restarted() {
+                ++restarts_;
+                run_ = 0;
+                filled_ = 0;
+                recent_sum_ = 0;
+                std::fill(recent_.begin(), recent_.end(), 0);
+                limit_ = nextLimit();
+        }
+
+private:
+        RestartConfig config_;
+        std::uint64_t restarts_ = 0, total_ = 0, run_ = 0, limit_ = 0;
+        std::uint64_t global_sum_ = 0, recent_sum_ = 0;
+        std::vector<unsigned> recent_;
+        std::size_t next_ = 0, filled_ = 0;
+        double geometric_ = 0;
+
+        // Conflicts until the next restart (Luby, Geometric) or before the LBD test may fire.
+        // At least 1, so a base of 0 cannot restart on every conflict forever.
+        std::uint64_t nextLimit() {
+                const double base = static_cast<double>(std::max<std::uint64_t>(config_.base, 1));
+                switch (config_.kind) {
+                case RestartConfig::Kind::Luby:
+                        return static_cast<std::uint64_t>(base) * luby(restarts_);
+                case RestartConfig::Kind::Geometric:
+                case RestartConfig::Kind::Lbd:
+                        geometric_ = geometric_ == 0 ? base : geometric_ * config_.factor;
+                        return std::max<std::uint64_t>(static_cast<std::uint64_t>(geometric_), 1);
+                default:
+                        return 0;
+                }
+        }
+};
+
+#endif // RESTARTS_HPP
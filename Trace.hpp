@@ -0,0 +1,132 @@
+// Trace.hpp
+//
+// Timeline Trace for NDP-4.5.7
+//
+// Copyright (c) 2025 GridSAT Stiftung
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// GridSAT Stiftung - Georgstr. 11 - 30159 Hannover - Germany - ipns://gridsat.eth - info@gridsat.io
+//
+//
+// +++ READ.me +++
+//
+// Save to working directory of NDP-4.5.7
+//
+// Records what every thread does over time - the BFS, the streaming producer, each
+// DFS task with its task number, cube size, node count and result - as complete
+// ("X") events in the Chrome trace format. Open the file in chrome://tracing or
+// https://ui.perfetto.dev: idle gaps between tasks and straggler tasks at the end of
+// the run show up directly. Events go to a per-thread buffer (one uncontended lock
+// per event, a few per task) and are written once, at the end of the run.
+//
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "PerThread.hpp"
+
+class Trace {
+public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Event {
+                const char *name;
+                const char *category;
+                int thread;
+                Clock::time_point start, end;
+                long long task = -1;            // the args below are only written when set
+                long long cube = -1;
+                long long nodes = -1;
+                const char *result = nullptr;
+        };
+
+        Trace() : start_(Clock::now()) { }
+
+        void configure(const std::string &path) { path_ = path; }
+        bool enabled() const { return !path_.empty(); }
+        const std::string &path() const { return path_; }
+
+        void nameThread(int thread, const std::string &name) {
+                if (!enabled())
+                        return;
+                std::lock_guard<std::mutex> lock(mutex_);
+                thread_names_[thread] = name;
+        }
+
+        void record(const Event &event) {
+                if (!enabled())
+                        return;
+                Buffer &buffer = buffers_.local();
+                std::lock_guard<std::mutex> lock(buffer.mutex);
+                buffer.events.push_back(event);
+        }
+
+        // Writes {"traceEvents": [...]}; other threads may still be recording.
+        bool write() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::ofstream out(path_, std::ios::trunc);
+                if (!out)
+                        return false;
+                out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+                bool first = true;
+                auto separator = [&]() { out << (first ? "" : ",\n"); first = false; };
+                for (const auto &entry : thread_names_) {
+                        separator();
+                        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << entry.first
+                            << ",\"args\":{\"name\":\"" << entry.second << "\"}}";
+                }
+                buffers_.forEach([&](const Buffer &buffer) {
+                        std::lock_guard<std::mutex> buffer_lock(buffer.mutex);
+                        for (const Event &e : buffer.events) {
+                                separator();
+                                out << "{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\",\"pid\":1"
+                                    << ",\"tid\":" << e.thread << ",\"ts\":" << micros(e.start) << ",\"dur\":" << micros(e.end) - micros(e.start)
+                                    << ",\"args\":{";
+                                const char *comma = "";
+                                if (e.task >= 0) { out << comma << "\"task\":" << e.task; comma = ","; }
+                                if (e.cube >= 0) { out << comma << "\"cube\":" << e.cube; comma = ","; }
+                                if (e.nodes >= 0) { out << comma << "\"nodes\":" << e.nodes; comma = ","; }
+                                if (e.result) { out << comma << "\"result\":\"" << e.result << "\""; }
+                                out << "}}";
+                        }
+                });
+                out << "\n]}\n";
+                return static_cast<bool>(out);
+        }
+
+private:
+        struct Buffer {
+                mutable std::mutex mutex;
+                std::vector<Event> events;
+        };
+
+        std::string path_;
+        Clock::time_point start_;
+        std::mutex mutex_;
+        PerThread<Buffer> buffers_;   // one per thread (the program has a single Trace)
+        std::map<int, std::string> thread_names_;
+
+        long long micros(Clock::time_point t) const {
+                return std::chrono::duration_cast<std::chrono::microseconds>(t - start_).count();
+        }
+};
+
+#endif // TRACE_HPP